@@ -0,0 +1,585 @@
+/*******************************************************************************
+* File Name: app_bt_adv.c
+*
+* Description: Source file for the advertising scheduler, which picks the advertising
+*              duty phase after boot, disconnection and advertising timeout
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "app_bt_cfg.h"
+#include "wiced_bt_uuid.h"
+#include "cycfg_gatt_db.h"
+#include "app_bt_adv.h"
+#include "app_bt_bond.h"
+#include "app_bt_conn.h"
+#include "app_time.h"
+#include "app_log.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* HCI disconnect reasons */
+#define APP_BT_DISC_REASON_CONN_TIMEOUT (0x08)  /* Supervision timeout, e.g. peer out of range */
+
+/* An advertising stop this close to the configured duration is taken to be the
+ * stack's own timeout rather than a stop caused by a connection */
+#define APP_BT_ADV_TIMEOUT_SLACK_MS     (1000u)
+
+/* The controller ends a high duty directed burst after 1.28 s. A burst that
+ * stopped earlier than this ended because the peer connected */
+#define APP_BT_ADV_DIRECTED_BURST_MS    (1280u)
+#define APP_BT_ADV_DIRECTED_SLACK_MS    (100u)
+
+/* Legacy advertising and scan response payloads are limited to 31 bytes */
+#define APP_BT_ADV_PAYLOAD_MAX          (31u)
+
+/* Bytes taken by an AD structure: length, type and data */
+#define APP_BT_ADV_ELEM_SIZE(data_len)  (2u + (data_len))
+
+/* Advertising intervals are in units of 0.625 ms */
+#define APP_BT_ADV_EVENTS(elapsed_ms, min_int, max_int) \
+    (((elapsed_ms) * 16u) / (5u * ((min_int) + (max_int))))
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Advertising payload: flags, Immediate Alert service UUID and appearance, so
+ * locators can filter on the service without a scan request */
+static uint8_t app_bt_adv_flag[] = { BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED };
+static uint8_t app_bt_adv_uuid[] = { BIT16_TO_8(UUID_SERVICE_IMMEDIATE_ALERT) };
+static uint8_t app_bt_adv_appearance[] = { BIT16_TO_8(APPEARANCE_GENERIC_KEYRING) };
+
+static wiced_bt_ble_advert_elem_t app_bt_adv_elem[] =
+{
+    { .advert_type = BTM_BLE_ADVERT_TYPE_FLAG,           .len = sizeof(app_bt_adv_flag),       .p_data = app_bt_adv_flag },
+    { .advert_type = BTM_BLE_ADVERT_TYPE_16SRV_COMPLETE, .len = sizeof(app_bt_adv_uuid),       .p_data = app_bt_adv_uuid },
+    { .advert_type = BTM_BLE_ADVERT_TYPE_APPEARANCE,     .len = sizeof(app_bt_adv_appearance), .p_data = app_bt_adv_appearance },
+};
+
+_Static_assert(APP_BT_ADV_ELEM_SIZE(sizeof(app_bt_adv_flag)) +
+               APP_BT_ADV_ELEM_SIZE(sizeof(app_bt_adv_uuid)) +
+               APP_BT_ADV_ELEM_SIZE(sizeof(app_bt_adv_appearance)) <= APP_BT_ADV_PAYLOAD_MAX,
+               "Advertising payload exceeds 31 bytes");
+
+/* Scan response payload: the device name. Its length comes from GeneratedSource
+ * when the payload is handed to the stack, so it always matches cycfg_bt.cybt */
+static wiced_bt_ble_advert_elem_t app_bt_adv_scan_rsp_elem[] =
+{
+    { .advert_type = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE, .len = 0, .p_data = app_gap_device_name },
+};
+
+static app_bt_adv_policy_t         app_bt_adv_policy = APP_BT_ADV_DEFAULT_POLICY;
+static wiced_bt_ble_advert_mode_t  app_bt_adv_mode = BTM_BLE_ADVERT_OFF;
+static uint32_t                    app_bt_adv_mode_start_ms = 0;
+static wiced_bool_t                app_bt_adv_mode_connected = WICED_FALSE;
+static uint32_t                    app_bt_adv_disconnect_ms = 0;
+static wiced_bool_t                app_bt_adv_awaiting_reconnect = WICED_FALSE;
+static uint8_t                     app_bt_adv_reason[APP_BT_ADV_REASON_HISTORY];
+static uint8_t                     app_bt_adv_reason_count = 0;
+static app_bt_adv_stats_t          app_bt_adv_stats;
+
+/* Target of directed advertising and the bursts left for it */
+static wiced_bt_device_address_t   app_bt_adv_peer_addr;
+static wiced_bt_ble_address_type_t app_bt_adv_peer_addr_type = BLE_ADDR_PUBLIC;
+static uint8_t                     app_bt_adv_directed_left = 0;
+static wiced_bool_t                app_bt_adv_directed_pending = WICED_FALSE;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_link_lost()
+***************************************************************************************************
+* Summary:
+*   This function reports whether recent disconnections look like the owner walking out of
+*   range rather than a locator closing the connection on purpose
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if the last disconnection, or at least half of the recent ones, timed out
+*
+**************************************************************************************************/
+static wiced_bool_t app_bt_adv_link_lost(void)
+{
+    uint8_t timeouts = 0;
+    uint8_t count = (app_bt_adv_reason_count < APP_BT_ADV_REASON_HISTORY) ? app_bt_adv_reason_count : APP_BT_ADV_REASON_HISTORY;
+
+    if (count == 0)
+    {
+        return WICED_FALSE;
+    }
+    if (app_bt_adv_reason[(app_bt_adv_reason_count - 1) % APP_BT_ADV_REASON_HISTORY] == APP_BT_DISC_REASON_CONN_TIMEOUT)
+    {
+        return WICED_TRUE;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        if (app_bt_adv_reason[i] == APP_BT_DISC_REASON_CONN_TIMEOUT)
+        {
+            timeouts++;
+        }
+    }
+    return (2u * timeouts >= count) ? WICED_TRUE : WICED_FALSE;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_account()
+***************************************************************************************************
+* Summary:
+*   This function adds the time spent in an advertising mode to the statistics
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t mode     : Advertising mode that just ended
+*   uint32_t elapsed_ms                 : Time spent in that mode
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_bt_adv_account(wiced_bt_ble_advert_mode_t mode, uint32_t elapsed_ms)
+{
+    const wiced_bt_cfg_ble_advert_settings_t *p_cfg = &wiced_bt_cfg_settings.ble_advert_cfg;
+
+    switch (mode)
+    {
+        case BTM_BLE_ADVERT_UNDIRECTED_HIGH:
+            app_bt_adv_stats.high_duty_ms += elapsed_ms;
+            app_bt_adv_stats.adv_events += APP_BT_ADV_EVENTS(elapsed_ms, p_cfg->high_duty_min_interval, p_cfg->high_duty_max_interval);
+            break;
+
+        case BTM_BLE_ADVERT_UNDIRECTED_LOW:
+            app_bt_adv_stats.low_duty_ms += elapsed_ms;
+            if (app_bt_adv_mode_connected)
+            {
+                app_bt_adv_stats.connected_ms += elapsed_ms;
+            }
+            app_bt_adv_stats.adv_events += APP_BT_ADV_EVENTS(elapsed_ms, p_cfg->low_duty_min_interval, p_cfg->low_duty_max_interval);
+            break;
+
+        case BTM_BLE_ADVERT_DIRECTED_HIGH:
+            app_bt_adv_stats.directed_ms += elapsed_ms;
+            app_bt_adv_stats.adv_events += APP_BT_ADV_EVENTS(elapsed_ms, p_cfg->high_duty_directed_min_interval, p_cfg->high_duty_directed_max_interval);
+            break;
+
+        case BTM_BLE_ADVERT_DIRECTED_LOW:
+            app_bt_adv_stats.directed_ms += elapsed_ms;
+            app_bt_adv_stats.adv_events += APP_BT_ADV_EVENTS(elapsed_ms, p_cfg->low_duty_directed_min_interval, p_cfg->low_duty_directed_max_interval);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_start_directed()
+***************************************************************************************************
+* Summary:
+*   This function starts one high duty directed advertising burst at the last peer. The
+*   controller ends the burst after 1.28 s if the peer does not connect
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_bt_adv_start_directed(void)
+{
+    app_bt_adv_directed_left--;
+    app_bt_adv_directed_pending = WICED_TRUE;
+    app_bt_adv_stats.directed_bursts++;
+
+    wiced_bt_start_advertisements(BTM_BLE_ADVERT_DIRECTED_HIGH, app_bt_adv_peer_addr_type, app_bt_adv_peer_addr);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_set_data()
+***************************************************************************************************
+* Summary:
+*   This function hands the prebuilt advertising and scan response payloads to the stack. The
+*   stack keeps them across advertising restarts, so this is only needed once
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_set_data(void)
+{
+    /* A name too long for the scan response is sent shortened, and marked so */
+    if (APP_BT_ADV_ELEM_SIZE(app_gap_device_name_len) <= APP_BT_ADV_PAYLOAD_MAX)
+    {
+        app_bt_adv_scan_rsp_elem[0].advert_type = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE;
+        app_bt_adv_scan_rsp_elem[0].len = app_gap_device_name_len;
+    }
+    else
+    {
+        WICED_BT_TRACE("Device name of %d bytes sent shortened in the scan response\n\r", app_gap_device_name_len);
+        app_bt_adv_scan_rsp_elem[0].advert_type = BTM_BLE_ADVERT_TYPE_NAME_SHORT;
+        app_bt_adv_scan_rsp_elem[0].len = APP_BT_ADV_PAYLOAD_MAX - APP_BT_ADV_ELEM_SIZE(0);
+    }
+
+    wiced_bt_ble_set_raw_advertisement_data(sizeof(app_bt_adv_elem) / sizeof(app_bt_adv_elem[0]), app_bt_adv_elem);
+    wiced_bt_ble_set_raw_scan_response_data(sizeof(app_bt_adv_scan_rsp_elem) / sizeof(app_bt_adv_scan_rsp_elem[0]), app_bt_adv_scan_rsp_elem);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_start()
+***************************************************************************************************
+* Summary:
+*   This function starts advertising after boot according to the active policy
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_start(void)
+{
+    /* The parameters for each duty phase are contained in 'app_bt_cfg.c' */
+    if (app_bt_adv_policy == APP_BT_ADV_POLICY_BATTERY_SAVER)
+    {
+        wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_LOW, 0, NULL);
+    }
+    else
+    {
+        wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_set_policy()
+***************************************************************************************************
+* Summary:
+*   This function selects the advertising policy. It applies from the next scheduling decision
+*
+* Parameters:
+*   app_bt_adv_policy_t policy          : Advertising policy
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_set_policy(app_bt_adv_policy_t policy)
+{
+    app_bt_adv_policy = policy;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function records a new connection for the reconnection statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_connect(void)
+{
+    uint32_t elapsed_ms = 0;
+
+    if (app_bt_adv_awaiting_reconnect)
+    {
+        elapsed_ms = app_time_ms() - app_bt_adv_disconnect_ms;
+
+        app_bt_adv_stats.reconnects++;
+        app_bt_adv_stats.last_reconnect_ms = elapsed_ms;
+        app_bt_adv_stats.total_reconnect_ms += elapsed_ms;
+        if (elapsed_ms > app_bt_adv_stats.max_reconnect_ms)
+        {
+            app_bt_adv_stats.max_reconnect_ms = elapsed_ms;
+        }
+        app_bt_adv_awaiting_reconnect = WICED_FALSE;
+
+        APP_LOG1(APP_LOG_ID_RECONNECTED, elapsed_ms);
+    }
+
+    if (app_bt_adv_directed_pending)
+    {
+        app_bt_adv_stats.directed_reconnects++;
+        app_bt_adv_directed_pending = WICED_FALSE;
+        app_bt_adv_directed_left = 0;
+    }
+
+    /* The controller stops advertising on a connection; leave room for the next locator */
+    app_bt_adv_update_connected();
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_update_connected()
+***************************************************************************************************
+* Summary:
+*   This function opens a low duty advertising window while at least one client is connected
+*   and more can attach, and stops advertising once APP_BT_MAX_CONN clients are connected or the
+*   battery saver policy is active. The window closes when ble_advert_cfg.low_duty_duration
+*   expires and only reopens on the next connection or disconnection
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_update_connected(void)
+{
+    uint8_t count = app_bt_conn_count();
+
+    if (count == 0)
+    {
+        /* Advertising without clients is up to app_bt_adv_on_disconnect() */
+        return;
+    }
+
+    if ((count < APP_BT_MAX_CONN) && APP_BT_ADV_WHILE_CONNECTED &&
+        (app_bt_adv_policy != APP_BT_ADV_POLICY_BATTERY_SAVER))
+    {
+        if (app_bt_adv_mode == BTM_BLE_ADVERT_OFF)
+        {
+            wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_LOW, 0, NULL);
+        }
+    }
+    else if (app_bt_adv_mode != BTM_BLE_ADVERT_OFF)
+    {
+        wiced_bt_start_advertisements(BTM_BLE_ADVERT_OFF, 0, NULL);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function restarts advertising after the last client disconnects, choosing the duty
+*   phase from the policy and the recent disconnect reasons. After a supervision timeout it
+*   first advertises directed at the peer that was lost
+*
+* Parameters:
+*   uint16_t reason                     : HCI disconnect reason
+*   wiced_bt_device_address_t bd_addr   : Address of the peer that disconnected
+*   wiced_bt_ble_address_type_t addr_type : Address type of that peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_disconnect(uint16_t reason, wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type)
+{
+    wiced_bt_ble_advert_mode_t mode = BTM_BLE_ADVERT_UNDIRECTED_LOW;
+    const wiced_bt_device_link_keys_t *p_keys = NULL;
+
+    app_bt_adv_reason[app_bt_adv_reason_count % APP_BT_ADV_REASON_HISTORY] = (uint8_t)reason;
+    app_bt_adv_reason_count++;
+    app_bt_adv_disconnect_ms = app_time_ms();
+    app_bt_adv_awaiting_reconnect = WICED_TRUE;
+
+    /* A peer that timed out is likely still looking for us: call it back
+     * directly before letting every scanner around see the tag */
+    if ((reason == APP_BT_DISC_REASON_CONN_TIMEOUT) && (APP_BT_ADV_DIRECTED_BURSTS > 0) &&
+        (app_bt_adv_policy != APP_BT_ADV_POLICY_BATTERY_SAVER))
+    {
+        /* For a bonded peer, target its identity address */
+        p_keys = app_bt_bond_find(bd_addr);
+        if (p_keys != NULL)
+        {
+            app_bt_bond_identity(p_keys, app_bt_adv_peer_addr, &app_bt_adv_peer_addr_type);
+        }
+        else
+        {
+            memcpy(app_bt_adv_peer_addr, bd_addr, sizeof(wiced_bt_device_address_t));
+            app_bt_adv_peer_addr_type = addr_type;
+        }
+
+        APP_LOG_BDA1(APP_LOG_ID_ADV_DIRECTED, app_bt_adv_peer_addr, APP_BT_ADV_DIRECTED_BURSTS);
+        app_bt_adv_directed_left = APP_BT_ADV_DIRECTED_BURSTS;
+        app_bt_adv_start_directed();
+        return;
+    }
+
+    switch (app_bt_adv_policy)
+    {
+        case APP_BT_ADV_POLICY_AGGRESSIVE_RECONNECT:
+            mode = BTM_BLE_ADVERT_UNDIRECTED_HIGH;
+            break;
+
+        case APP_BT_ADV_POLICY_BALANCED:
+            /* Only chase a locator that lost the link; one that closed it can wait */
+            mode = app_bt_adv_link_lost() ? BTM_BLE_ADVERT_UNDIRECTED_HIGH : BTM_BLE_ADVERT_UNDIRECTED_LOW;
+            break;
+
+        default:
+            break;
+    }
+
+    APP_LOG3(APP_LOG_ID_ADV_POLICY, app_bt_adv_policy, reason, mode);
+    wiced_bt_start_advertisements(mode, 0, NULL);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_state_changed()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_ADVERT_STATE_CHANGED_EVT. It accounts the time spent in the
+*   previous mode and, when the stack stops advertising on timeout, decides whether to resume.
+*   While clients are connected, advertising stopped by a connection resumes as long as another
+*   client can attach; advertising stopped by the timeout stays off
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t mode     : New advertising mode
+*   wiced_bool_t connected              : WICED_TRUE if any client is connected
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_state_changed(wiced_bt_ble_advert_mode_t mode, wiced_bool_t connected)
+{
+    uint32_t now_ms = app_time_ms();
+    uint32_t elapsed_ms = now_ms - app_bt_adv_mode_start_ms;
+    uint32_t low_duty_ms = wiced_bt_cfg_settings.ble_advert_cfg.low_duty_duration * 1000u;
+    wiced_bt_ble_advert_mode_t prev_mode = app_bt_adv_mode;
+    wiced_bool_t timed_out = WICED_FALSE;
+
+    app_bt_adv_account(prev_mode, elapsed_ms);
+    app_bt_adv_mode = mode;
+    app_bt_adv_mode_start_ms = now_ms;
+    app_bt_adv_mode_connected = connected;
+
+    /* Only a low duty phase that ran its full duration is a timeout; a shorter
+     * one ended because a client connected */
+    if ((mode == BTM_BLE_ADVERT_OFF) && (prev_mode == BTM_BLE_ADVERT_UNDIRECTED_LOW) &&
+        (low_duty_ms != 0) && (elapsed_ms + APP_BT_ADV_TIMEOUT_SLACK_MS >= low_duty_ms))
+    {
+        timed_out = WICED_TRUE;
+    }
+
+    /* Advertising stopped while clients are connected. After a connection,
+     * resume at low duty if there is room for another client; after a timeout,
+     * stay off until the next connection or disconnection, so a connected tag
+     * does not advertise for as long as it stays connected */
+    if ((mode == BTM_BLE_ADVERT_OFF) && connected)
+    {
+        if (!timed_out)
+        {
+            app_bt_adv_update_connected();
+        }
+        return;
+    }
+
+    /* A directed burst ran its full length without a connection: repeat it, or
+     * fall back to undirected advertising once the bursts are used up. A
+     * shorter one ended because the peer connected; the connection event that
+     * follows ends the directed phase */
+    if (app_bt_adv_directed_pending && !connected &&
+        (prev_mode == BTM_BLE_ADVERT_DIRECTED_HIGH) && (mode != BTM_BLE_ADVERT_DIRECTED_HIGH))
+    {
+        if (elapsed_ms + APP_BT_ADV_DIRECTED_SLACK_MS < APP_BT_ADV_DIRECTED_BURST_MS)
+        {
+            return;
+        }
+
+        if (app_bt_adv_directed_left > 0)
+        {
+            app_bt_adv_start_directed();
+        }
+        else
+        {
+            app_bt_adv_directed_pending = WICED_FALSE;
+            wiced_bt_start_advertisements(APP_BT_ADV_DIRECTED_FALLBACK, 0, NULL);
+        }
+        return;
+    }
+
+    if (!timed_out)
+    {
+        return;
+    }
+
+    switch (app_bt_adv_policy)
+    {
+        case APP_BT_ADV_POLICY_AGGRESSIVE_RECONNECT:
+            wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_LOW, 0, NULL);
+            break;
+
+        case APP_BT_ADV_POLICY_BALANCED:
+            if (now_ms - app_bt_adv_disconnect_ms < APP_BT_ADV_BALANCED_WINDOW_MS)
+            {
+                wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_LOW, 0, NULL);
+            }
+            break;
+
+        default:
+            /* Battery saver: stay off until the next boot or disconnection */
+            break;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the advertising statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_bt_adv_stats_t *app_bt_adv_get_stats(void)
+{
+    return &app_bt_adv_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,252 @@
+/*******************************************************************************
+* File Name: app_bt_adv.h
+*
+* Description: Header file for the advertising scheduler, which picks the advertising
+*              duty phase after boot, disconnection and advertising timeout
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BT_ADV_H_
+#define APP_BT_ADV_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Policy used from boot; see app_bt_adv_policy_t */
+#ifndef APP_BT_ADV_DEFAULT_POLICY
+#define APP_BT_ADV_DEFAULT_POLICY       APP_BT_ADV_POLICY_BALANCED
+#endif
+
+/* Balanced policy: keep low duty advertising going for this long after the
+ * last connection before giving up */
+#ifndef APP_BT_ADV_BALANCED_WINDOW_MS
+#define APP_BT_ADV_BALANCED_WINDOW_MS   (10u * 60u * 1000u)
+#endif
+
+/* High duty directed advertising bursts (1.28 s each) aimed at the last peer
+ * after a supervision timeout, before falling back to undirected advertising.
+ * 0 disables directed advertising */
+#ifndef APP_BT_ADV_DIRECTED_BURSTS
+#define APP_BT_ADV_DIRECTED_BURSTS      (2u)
+#endif
+
+/* After each connection or disconnection that leaves clients connected, and
+ * while fewer than APP_BT_MAX_CONN are attached, advertise at low duty for one
+ * ble_advert_cfg.low_duty_duration so another locator can connect without
+ * waiting for a disconnection. The battery saver policy never advertises while
+ * connected. 0 stops advertising on the first connection */
+#ifndef APP_BT_ADV_WHILE_CONNECTED
+#define APP_BT_ADV_WHILE_CONNECTED      (1u)
+#endif
+
+/* Mode started once the directed bursts are used up */
+#ifndef APP_BT_ADV_DIRECTED_FALLBACK
+#define APP_BT_ADV_DIRECTED_FALLBACK    BTM_BLE_ADVERT_UNDIRECTED_HIGH
+#endif
+
+/* Number of recent disconnect reasons kept to judge whether the owner is
+ * walking out of range */
+#define APP_BT_ADV_REASON_HISTORY       (4u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Advertising policies, trading reconnection latency against radio-on time */
+typedef enum
+{
+    /* High duty after every disconnect, and low duty advertising that never stops */
+    APP_BT_ADV_POLICY_AGGRESSIVE_RECONNECT,
+    /* High duty only after link loss; low duty is kept up for
+     * APP_BT_ADV_BALANCED_WINDOW_MS after the last connection */
+    APP_BT_ADV_POLICY_BALANCED,
+    /* Low duty only, stopping when ble_advert_cfg.low_duty_duration expires */
+    APP_BT_ADV_POLICY_BATTERY_SAVER,
+} app_bt_adv_policy_t;
+
+/* Advertising statistics */
+typedef struct
+{
+    uint32_t high_duty_ms;          /* Time spent advertising at high duty */
+    uint32_t low_duty_ms;           /* Time spent advertising at low duty */
+    uint32_t connected_ms;          /* Part of the above spent with a client connected */
+    uint32_t directed_ms;           /* Time spent advertising directed at the last peer */
+    uint32_t directed_bursts;       /* Directed advertising bursts started */
+    uint32_t directed_reconnects;   /* Reconnections made during a directed burst */
+    uint32_t adv_events;            /* Estimated advertising events, i.e. radio wakeups */
+    uint32_t reconnects;            /* Connections following a disconnection */
+    uint32_t last_reconnect_ms;     /* Time from the last disconnection to the next connection */
+    uint32_t max_reconnect_ms;      /* Longest time to reconnect */
+    uint32_t total_reconnect_ms;    /* Sum of all times to reconnect, for the average */
+} app_bt_adv_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_bt_adv_set_data()
+***************************************************************************************************
+* Summary:
+*   This function hands the prebuilt advertising and scan response payloads to the stack. The
+*   stack keeps them across advertising restarts, so this is only needed once
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_set_data(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_start()
+***************************************************************************************************
+* Summary:
+*   This function starts advertising after boot according to the active policy
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_start(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_set_policy()
+***************************************************************************************************
+* Summary:
+*   This function selects the advertising policy. It applies from the next scheduling decision
+*
+* Parameters:
+*   app_bt_adv_policy_t policy          : Advertising policy
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_set_policy(app_bt_adv_policy_t policy);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function records a new connection for the reconnection statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_connect(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_update_connected()
+***************************************************************************************************
+* Summary:
+*   This function keeps low duty advertising going while at least one client is connected and
+*   more can attach, and stops it once APP_BT_MAX_CONN clients are connected
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_update_connected(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function restarts advertising after the last client disconnects, choosing the duty
+*   phase from the policy and the recent disconnect reasons. After a supervision timeout it
+*   first advertises directed at the peer that was lost
+*
+* Parameters:
+*   uint16_t reason                     : HCI disconnect reason
+*   wiced_bt_device_address_t bd_addr   : Address of the peer that disconnected
+*   wiced_bt_ble_address_type_t addr_type : Address type of that peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_disconnect(uint16_t reason, wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_on_state_changed()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_ADVERT_STATE_CHANGED_EVT. It accounts the time spent in the
+*   previous mode and, when the stack stops advertising on timeout, decides whether to resume
+*
+* Parameters:
+*   wiced_bt_ble_advert_mode_t mode     : New advertising mode
+*   wiced_bool_t connected              : WICED_TRUE if any client is connected
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_adv_on_state_changed(wiced_bt_ble_advert_mode_t mode, wiced_bool_t connected);
+
+/**************************************************************************************************
+* Function Name: app_bt_adv_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the advertising statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_bt_adv_stats_t *app_bt_adv_get_stats(void);
+
+#endif /* APP_BT_ADV_H_ */
@@ -0,0 +1,502 @@
+/*******************************************************************************
+* File Name: app_bt_bond.c
+*
+* Description: Source file for the bond table, an NVRAM-backed store of peer link keys
+*              and the local identity keys with a RAM cache in front of it
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "app_bt_bond.h"
+#include "app_time.h"
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* RAM cache of the NVRAM bond records */
+static wiced_bt_device_link_keys_t    app_bt_bond_cache[APP_BT_BOND_MAX];
+static wiced_bool_t                   app_bt_bond_valid[APP_BT_BOND_MAX];
+static wiced_bt_local_identity_keys_t app_bt_bond_local_keys;
+static wiced_bool_t                   app_bt_bond_local_keys_valid = WICED_FALSE;
+
+/* Slot replaced by the next bond when the table is full. Slots are filled in
+ * order and replaced in the same order, so this is always the oldest bond;
+ * it is kept in NVRAM so the order survives a reset */
+static uint8_t                        app_bt_bond_next = 0;
+
+/* WICED_TRUE until APP_BT_BOND_PAIRING_WINDOW_MS after power-up */
+static wiced_bool_t                   app_bt_bond_pairing_open = WICED_TRUE;
+static wiced_timer_t                  app_bt_bond_pairing_timer;
+
+/* Slot of the last successful lookup; a key request normally follows the
+ * connection of the same peer */
+static uint8_t                        app_bt_bond_last_hit = 0;
+
+static app_bt_bond_stats_t            app_bt_bond_stats;
+
+/* Security action requested from returning bonded peers */
+static wiced_bt_ble_sec_action_type_t app_bt_bond_sec_action = BTM_BLE_SEC_ENCRYPT;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_pairing_timeout()
+***************************************************************************************************
+* Summary:
+*   This function closes the pairing window, so a new peer can no longer replace a bond
+*
+* Parameters:
+*   uint32_t arg                        : Unused
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_bt_bond_pairing_timeout(uint32_t arg)
+{
+    app_bt_bond_pairing_open = WICED_FALSE;
+    WICED_BT_TRACE("Pairing window closed\n\r");
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_slot()
+***************************************************************************************************
+* Summary:
+*   This function returns the cache slot holding a peer. The slot of the last lookup is checked
+*   first; otherwise the search is bounded by APP_BT_BOND_MAX
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   Slot index, or APP_BT_BOND_MAX if the peer is not bonded
+*
+**************************************************************************************************/
+static uint8_t app_bt_bond_slot(wiced_bt_device_address_t bd_addr)
+{
+    if (app_bt_bond_valid[app_bt_bond_last_hit] &&
+        (memcmp(app_bt_bond_cache[app_bt_bond_last_hit].bd_addr, bd_addr, BD_ADDR_LEN) == 0))
+    {
+        return app_bt_bond_last_hit;
+    }
+
+    for (uint8_t i = 0; i < APP_BT_BOND_MAX; i++)
+    {
+        if (app_bt_bond_valid[i] && (memcmp(app_bt_bond_cache[i].bd_addr, bd_addr, BD_ADDR_LEN) == 0))
+        {
+            app_bt_bond_last_hit = i;
+            return i;
+        }
+    }
+    return APP_BT_BOND_MAX;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_init()
+***************************************************************************************************
+* Summary:
+*   This function loads the bond table from NVRAM into the RAM cache and adds the bonded peers
+*   to the address resolution list, so privacy-enabled peers are recognized. It also opens the
+*   pairing window
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_init(void)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+    uint8_t bonds = 0;
+
+    app_bt_bond_local_keys_valid =
+        (wiced_hal_read_nvram(APP_BT_BOND_VSID_LOCAL_KEYS, sizeof(app_bt_bond_local_keys),
+                (uint8_t *)&app_bt_bond_local_keys, &result) == sizeof(app_bt_bond_local_keys)) &&
+        (result == WICED_BT_SUCCESS);
+
+    for (uint8_t i = 0; i < APP_BT_BOND_MAX; i++)
+    {
+        app_bt_bond_valid[i] =
+            (wiced_hal_read_nvram(APP_BT_BOND_VSID_LINK_KEYS(i), sizeof(wiced_bt_device_link_keys_t),
+                    (uint8_t *)&app_bt_bond_cache[i], &result) == sizeof(wiced_bt_device_link_keys_t)) &&
+            (result == WICED_BT_SUCCESS);
+
+        if (app_bt_bond_valid[i])
+        {
+            wiced_bt_dev_add_device_to_address_resolution_db(&app_bt_bond_cache[i]);
+            bonds++;
+        }
+    }
+
+    if ((wiced_hal_read_nvram(APP_BT_BOND_VSID_NEXT, sizeof(app_bt_bond_next), &app_bt_bond_next, &result) !=
+            sizeof(app_bt_bond_next)) || (result != WICED_BT_SUCCESS) || (app_bt_bond_next >= APP_BT_BOND_MAX))
+    {
+        app_bt_bond_next = 0;
+    }
+
+    wiced_init_timer(&app_bt_bond_pairing_timer, app_bt_bond_pairing_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+    wiced_start_timer(&app_bt_bond_pairing_timer, APP_BT_BOND_PAIRING_WINDOW_MS);
+
+    WICED_BT_TRACE("Bond table: %d of %d in use\n\r", bonds, APP_BT_BOND_MAX);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_pairing_allowed()
+***************************************************************************************************
+* Summary:
+*   This function decides whether a peer may pair. A bonded peer may always pair again, and a
+*   new peer may pair while a slot is free or the pairing window is open
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   wiced_bool_t: WICED_TRUE if pairing is allowed
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_bond_pairing_allowed(wiced_bt_device_address_t bd_addr)
+{
+    if (app_bt_bond_pairing_open || (app_bt_bond_slot(bd_addr) < APP_BT_BOND_MAX))
+    {
+        return WICED_TRUE;
+    }
+
+    for (uint8_t i = 0; i < APP_BT_BOND_MAX; i++)
+    {
+        if (!app_bt_bond_valid[i])
+        {
+            return WICED_TRUE;
+        }
+    }
+    return WICED_FALSE;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_find()
+***************************************************************************************************
+* Summary:
+*   This function returns the cached link keys of a bonded peer
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   Pointer to the cached link keys, or NULL if the peer is not bonded
+*
+**************************************************************************************************/
+const wiced_bt_device_link_keys_t *app_bt_bond_find(wiced_bt_device_address_t bd_addr)
+{
+    uint8_t slot = app_bt_bond_slot(bd_addr);
+
+    return (slot < APP_BT_BOND_MAX) ? &app_bt_bond_cache[slot] : NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get()
+***************************************************************************************************
+* Summary:
+*   This function returns the cached link keys held in a bond slot, to walk the bonded peers
+*
+* Parameters:
+*   uint8_t slot                        : Slot index, 0 to APP_BT_BOND_MAX - 1
+*
+* Return:
+*   Pointer to the cached link keys, or NULL if the slot is free
+*
+**************************************************************************************************/
+const wiced_bt_device_link_keys_t *app_bt_bond_get(uint8_t slot)
+{
+    return ((slot < APP_BT_BOND_MAX) && app_bt_bond_valid[slot]) ? &app_bt_bond_cache[slot] : NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_identity()
+***************************************************************************************************
+* Summary:
+*   This function returns the address to reach a bonded peer at. A peer that distributed its
+*   identity key may use resolvable private addresses, so the address it bonded from can be
+*   stale; its identity address is used instead, and the controller resolves it through the
+*   address resolution list
+*
+* Parameters:
+*   const wiced_bt_device_link_keys_t *p_keys : Link keys of the peer
+*   wiced_bt_device_address_t bd_addr   : Filled with the address to use
+*   wiced_bt_ble_address_type_t *p_addr_type : Filled with its address type
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_identity(const wiced_bt_device_link_keys_t *p_keys, wiced_bt_device_address_t bd_addr,
+                          wiced_bt_ble_address_type_t *p_addr_type)
+{
+    if (p_keys->key_data.le_keys_available_mask & BTM_LE_KEY_PID)
+    {
+        memcpy(bd_addr, p_keys->key_data.static_addr, sizeof(wiced_bt_device_address_t));
+        *p_addr_type = p_keys->key_data.static_addr_type;
+    }
+    else
+    {
+        memcpy(bd_addr, p_keys->bd_addr, sizeof(wiced_bt_device_address_t));
+        *p_addr_type = p_keys->key_data.ble_addr_type;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_save_link_keys()
+***************************************************************************************************
+* Summary:
+*   This function stores the link keys of a peer in the cache and in NVRAM. It handles
+*   BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys : Link keys reported by the BT stack
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the keys were written to NVRAM
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_save_link_keys(wiced_bt_device_link_keys_t *p_keys)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+    uint8_t slot = app_bt_bond_slot(p_keys->bd_addr);
+
+    if (slot >= APP_BT_BOND_MAX)
+    {
+        /* New peer: take a free slot, or replace the oldest bond */
+        for (slot = 0; slot < APP_BT_BOND_MAX; slot++)
+        {
+            if (!app_bt_bond_valid[slot])
+            {
+                break;
+            }
+        }
+
+        if (slot >= APP_BT_BOND_MAX)
+        {
+            slot = app_bt_bond_next;
+            app_bt_bond_next = (uint8_t)((app_bt_bond_next + 1) % APP_BT_BOND_MAX);
+            wiced_hal_write_nvram(APP_BT_BOND_VSID_NEXT, sizeof(app_bt_bond_next), &app_bt_bond_next, &result);
+
+            /* The replaced peer must no longer resolve to a bonded identity */
+            WICED_BT_TRACE("Replacing bond of %B\n\r", app_bt_bond_cache[slot].bd_addr);
+            wiced_bt_dev_remove_device_from_address_resolution_db(&app_bt_bond_cache[slot]);
+            app_bt_bond_valid[slot] = WICED_FALSE;
+        }
+    }
+
+    /* Skip the NVRAM write when nothing changed */
+    if (app_bt_bond_valid[slot] &&
+        (memcmp(&app_bt_bond_cache[slot], p_keys, sizeof(wiced_bt_device_link_keys_t)) == 0))
+    {
+        return WICED_BT_SUCCESS;
+    }
+
+    memcpy(&app_bt_bond_cache[slot], p_keys, sizeof(wiced_bt_device_link_keys_t));
+    app_bt_bond_valid[slot] = WICED_TRUE;
+    app_bt_bond_last_hit = slot;
+
+    wiced_hal_write_nvram(APP_BT_BOND_VSID_LINK_KEYS(slot), sizeof(wiced_bt_device_link_keys_t), (uint8_t *)p_keys, &result);
+    wiced_bt_dev_add_device_to_address_resolution_db(p_keys);
+
+    WICED_BT_TRACE("Bonded %B in slot %d, NVRAM result %d\n\r", p_keys->bd_addr, slot, result);
+    return result;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_link_keys()
+***************************************************************************************************
+* Summary:
+*   This function answers BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT from the RAM cache
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys : Request from the BT stack; bd_addr is the input and
+*                                         key_data is filled in
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the peer is bonded, WICED_BT_ERROR otherwise
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_get_link_keys(wiced_bt_device_link_keys_t *p_keys)
+{
+    uint8_t slot = app_bt_bond_slot(p_keys->bd_addr);
+
+    if (slot >= APP_BT_BOND_MAX)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    memcpy(&p_keys->key_data, &app_bt_bond_cache[slot].key_data, sizeof(p_keys->key_data));
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_save_local_keys()
+***************************************************************************************************
+* Summary:
+*   This function stores the local identity keys in the cache and in NVRAM. It handles
+*   BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys : Local identity keys reported by the BT stack
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the keys were written to NVRAM
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_save_local_keys(wiced_bt_local_identity_keys_t *p_keys)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+
+    memcpy(&app_bt_bond_local_keys, p_keys, sizeof(wiced_bt_local_identity_keys_t));
+    app_bt_bond_local_keys_valid = WICED_TRUE;
+
+    wiced_hal_write_nvram(APP_BT_BOND_VSID_LOCAL_KEYS, sizeof(wiced_bt_local_identity_keys_t), (uint8_t *)p_keys, &result);
+    return result;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_local_keys()
+***************************************************************************************************
+* Summary:
+*   This function answers BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT from the RAM cache
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys : Filled in with the local identity keys
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if keys were stored before, WICED_BT_ERROR to let the
+*   stack generate new ones
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_get_local_keys(wiced_bt_local_identity_keys_t *p_keys)
+{
+    if (!app_bt_bond_local_keys_valid)
+    {
+        return WICED_BT_ERROR;
+    }
+
+    memcpy(p_keys, &app_bt_bond_local_keys, sizeof(wiced_bt_local_identity_keys_t));
+    return WICED_BT_SUCCESS;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function asks a returning bonded peer to resume encryption right after it connects
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   wiced_bool_t: WICED_TRUE if the peer is bonded
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_bond_on_connect(wiced_bt_device_address_t bd_addr)
+{
+    /* As peripheral this sends a Security Request, so the central starts
+     * encryption with the stored keys instead of waiting for a secured access */
+    if (app_bt_bond_slot(bd_addr) < APP_BT_BOND_MAX)
+    {
+        wiced_bt_dev_set_encryption(bd_addr, BT_TRANSPORT_LE, &app_bt_bond_sec_action);
+        return WICED_TRUE;
+    }
+    return WICED_FALSE;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_on_encrypted()
+***************************************************************************************************
+* Summary:
+*   This function handles a successful BTM_ENCRYPTION_STATUS_EVT and records the connection to
+*   encryption time of bonded peers. It is only called for links encrypted with stored keys,
+*   not for links on which the peer paired
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*   uint32_t connect_ms                 : app_time_ms() timestamp of the connection
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_on_encrypted(wiced_bt_device_address_t bd_addr, uint32_t connect_ms)
+{
+    uint32_t elapsed_ms = app_time_ms() - connect_ms;
+
+    if (app_bt_bond_slot(bd_addr) < APP_BT_BOND_MAX)
+    {
+        app_bt_bond_stats.encrypted_reconnects++;
+        app_bt_bond_stats.last_encrypt_ms = elapsed_ms;
+        app_bt_bond_stats.total_encrypt_ms += elapsed_ms;
+        if (elapsed_ms > app_bt_bond_stats.max_encrypt_ms)
+        {
+            app_bt_bond_stats.max_encrypt_ms = elapsed_ms;
+        }
+
+        WICED_BT_TRACE("Encrypted %B %d ms after connecting\n\r", bd_addr, elapsed_ms);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the reconnection to encryption statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_bt_bond_stats_t *app_bt_bond_get_stats(void)
+{
+    return &app_bt_bond_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,288 @@
+/*******************************************************************************
+* File Name: app_bt_bond.h
+*
+* Description: Header file for the bond table, an NVRAM-backed store of peer link keys
+*              and the local identity keys with a RAM cache in front of it
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BT_BOND_H_
+#define APP_BT_BOND_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "wiced_hal_nvram.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Number of bonded peers remembered. When the table is full, a new bond
+ * replaces the oldest one */
+#ifndef APP_BT_BOND_MAX
+#define APP_BT_BOND_MAX                 (4u)
+#endif
+
+/* Time after power-up during which a new peer may replace the oldest bond.
+ * Outside it, new peers can only pair while a slot is free, so a stranger
+ * cannot push the owner's bonds out of a full table */
+#ifndef APP_BT_BOND_PAIRING_WINDOW_MS
+#define APP_BT_BOND_PAIRING_WINDOW_MS   (120000u)
+#endif
+
+/* NVRAM layout: the local identity keys, one record per bond slot, then the
+ * slot replaced by the next bond when the table is full.
+ * Identifiers from APP_BT_BOND_VSID_END onwards are free for other modules */
+#define APP_BT_BOND_VSID_LOCAL_KEYS     (WICED_NVRAM_VSID_START)
+#define APP_BT_BOND_VSID_LINK_KEYS(i)   (WICED_NVRAM_VSID_START + 1u + (i))
+#define APP_BT_BOND_VSID_NEXT           (APP_BT_BOND_VSID_LINK_KEYS(APP_BT_BOND_MAX))
+#define APP_BT_BOND_VSID_END            (APP_BT_BOND_VSID_NEXT + 1u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Time from connection to an encrypted link for returning bonded peers. Links
+ * on which the peer pairs are not counted */
+typedef struct
+{
+    uint32_t encrypted_reconnects;  /* Links to bonded peers that became encrypted with stored keys */
+    uint32_t last_encrypt_ms;       /* Connection to encryption time of the last one */
+    uint32_t max_encrypt_ms;        /* Longest connection to encryption time */
+    uint32_t total_encrypt_ms;      /* Sum of all connection to encryption times, for the average */
+} app_bt_bond_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_bt_bond_init()
+***************************************************************************************************
+* Summary:
+*   This function loads the bond table from NVRAM into the RAM cache and adds the bonded peers
+*   to the address resolution list, so privacy-enabled peers are recognized. It also opens the
+*   pairing window
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_init(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_pairing_allowed()
+***************************************************************************************************
+* Summary:
+*   This function decides whether a peer may pair. A bonded peer may always pair again, and a
+*   new peer may pair while a slot is free or the pairing window is open
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   wiced_bool_t: WICED_TRUE if pairing is allowed
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_bond_pairing_allowed(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_find()
+***************************************************************************************************
+* Summary:
+*   This function returns the cached link keys of a bonded peer
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   Pointer to the cached link keys, or NULL if the peer is not bonded
+*
+**************************************************************************************************/
+const wiced_bt_device_link_keys_t *app_bt_bond_find(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get()
+***************************************************************************************************
+* Summary:
+*   This function returns the cached link keys held in a bond slot, to walk the bonded peers
+*
+* Parameters:
+*   uint8_t slot                        : Slot index, 0 to APP_BT_BOND_MAX - 1
+*
+* Return:
+*   Pointer to the cached link keys, or NULL if the slot is free
+*
+**************************************************************************************************/
+const wiced_bt_device_link_keys_t *app_bt_bond_get(uint8_t slot);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_identity()
+***************************************************************************************************
+* Summary:
+*   This function returns the address to reach a bonded peer at. A peer that distributed its
+*   identity key may use resolvable private addresses, so the address it bonded from can be
+*   stale; its identity address is used instead, and the controller resolves it through the
+*   address resolution list
+*
+* Parameters:
+*   const wiced_bt_device_link_keys_t *p_keys : Link keys of the peer
+*   wiced_bt_device_address_t bd_addr   : Filled with the address to use
+*   wiced_bt_ble_address_type_t *p_addr_type : Filled with its address type
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_identity(const wiced_bt_device_link_keys_t *p_keys, wiced_bt_device_address_t bd_addr,
+                          wiced_bt_ble_address_type_t *p_addr_type);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_save_link_keys()
+***************************************************************************************************
+* Summary:
+*   This function stores the link keys of a peer in the cache and in NVRAM. It handles
+*   BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys : Link keys reported by the BT stack
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the keys were written to NVRAM
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_save_link_keys(wiced_bt_device_link_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_link_keys()
+***************************************************************************************************
+* Summary:
+*   This function answers BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT from the RAM cache
+*
+* Parameters:
+*   wiced_bt_device_link_keys_t *p_keys : Request from the BT stack; bd_addr is the input and
+*                                         key_data is filled in
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the peer is bonded, WICED_BT_ERROR otherwise
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_get_link_keys(wiced_bt_device_link_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_save_local_keys()
+***************************************************************************************************
+* Summary:
+*   This function stores the local identity keys in the cache and in NVRAM. It handles
+*   BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys : Local identity keys reported by the BT stack
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if the keys were written to NVRAM
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_save_local_keys(wiced_bt_local_identity_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_local_keys()
+***************************************************************************************************
+* Summary:
+*   This function answers BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT from the RAM cache
+*
+* Parameters:
+*   wiced_bt_local_identity_keys_t *p_keys : Filled in with the local identity keys
+*
+* Return:
+*   wiced_result_t: WICED_BT_SUCCESS if keys were stored before, WICED_BT_ERROR to let the
+*   stack generate new ones
+*
+**************************************************************************************************/
+wiced_result_t app_bt_bond_get_local_keys(wiced_bt_local_identity_keys_t *p_keys);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function asks a returning bonded peer to resume encryption right after it connects
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   wiced_bool_t: WICED_TRUE if the peer is bonded
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_bond_on_connect(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_on_encrypted()
+***************************************************************************************************
+* Summary:
+*   This function handles a successful BTM_ENCRYPTION_STATUS_EVT and records the connection to
+*   encryption time of bonded peers. It is only called for links encrypted with stored keys,
+*   not for links on which the peer paired
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*   uint32_t connect_ms                 : app_time_ms() timestamp of the connection
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_bond_on_encrypted(wiced_bt_device_address_t bd_addr, uint32_t connect_ms);
+
+/**************************************************************************************************
+* Function Name: app_bt_bond_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the reconnection to encryption statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_bt_bond_stats_t *app_bt_bond_get_stats(void);
+
+#endif /* APP_BT_BOND_H_ */
@@ -53,7 +53,7 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
     .device_class                        = {0x00, 0x00, 0x00},                                         /**< Local device class */
     .security_requirement_mask           = BTM_SEC_NONE,                                               /**< Security requirements mask (BTM_SEC_NONE, or combinination of BTM_SEC_IN_AUTHENTICATE, BTM_SEC_OUT_AUTHENTICATE, BTM_SEC_ENCRYPT (see #wiced_bt_sec_level_e)) */
 
-    .max_simultaneous_links              = 3,                                                          /**< Maximum number simultaneous links to different devices */
+    .max_simultaneous_links              = APP_BT_MAX_LINKS,                                           /**< Maximum number simultaneous links to different devices */
 
     .br_edr_scan_cfg =                                              /* BR/EDR scan config */
     {
@@ -127,8 +127,8 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
     .gatt_cfg =                                                     /* GATT configuration */
     {
         .appearance                     = APPEARANCE_GENERIC_TAG,                                      /**< GATT appearance (see gatt_appearance_e) */
-        .client_max_links               = 0,                                                           /**< Client config: maximum number of servers that local client can connect to  */
-        .server_max_links               = 1,                                                           /**< Server config: maximum number of remote clients connections allowed by the local */
+        .client_max_links               = APP_BT_MAX_CLIENT_CONN,                                      /**< Client config: maximum number of servers that local client can connect to  */
+        .server_max_links               = APP_BT_MAX_CONN,                                             /**< Server config: maximum number of remote clients connections allowed by the local */
         .max_attr_len                   = 512,                                                         /**< Maximum attribute length; gki_cfg must have a corresponding buffer pool that can hold this length */
 #if !defined(CYW20706A2)
         .max_mtu_size                   = 517                                                          /**< Maximum MTU size for GATT connections, should be between 23 and (max_attr_len + 5) */
@@ -194,7 +194,8 @@ const wiced_bt_cfg_settings_t wiced_bt_cfg_settings =
 #endif
 };
 
-/* TODO set the application buffer pool as per your use case */
+/* Size the application buffer pools for your use case: build with BUF_POOL_STATS=1
+ * and use the recommended table traced when a client disconnects */
 /*****************************************************************************
  * wiced_bt_stack buffer pool configuration
  *
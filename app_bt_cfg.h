@@ -42,6 +42,22 @@
 
 #include "wiced_bt_cfg.h"
 
+/* Number of simultaneous GATT client connections the application keeps
+ * per-connection state for. Used for gatt_cfg.server_max_links */
+#define APP_BT_MAX_CONN                 (3)
+
+/* Number of links the Find Me locator role opens to bonded peers at once.
+ * Used for gatt_cfg.client_max_links */
+#ifdef APP_LOCATOR
+#define APP_BT_MAX_CLIENT_CONN          (1)
+#else
+#define APP_BT_MAX_CLIENT_CONN          (0)
+#endif
+
+/* Links of both roles open at once, used for max_simultaneous_links */
+#define APP_BT_MAX_LINKS                (APP_BT_MAX_CONN + APP_BT_MAX_CLIENT_CONN)
+
 extern const wiced_bt_cfg_settings_t wiced_bt_cfg_settings;
+extern const wiced_bt_cfg_buf_pool_t wiced_bt_cfg_buf_pools[WICED_BT_CFG_NUM_BUF_POOLS];
 
 #endif /* APP_BT_CFG_H_ */
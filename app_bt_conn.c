@@ -0,0 +1,326 @@
+/*******************************************************************************
+* File Name: app_bt_conn.c
+*
+* Description: Source file for per-connection state kept by the application
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_bt_conn.h"
+#include "app_bt_cfg.h"
+#include "app_time.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#if !defined(CYW20706A2)
+#define APP_BT_LOCAL_MAX_MTU            (wiced_bt_cfg_settings.gatt_cfg.max_mtu_size)
+#else
+#define APP_BT_LOCAL_MAX_MTU            (wiced_bt_cfg_settings.max_mtu_size)
+#endif
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static app_bt_conn_t app_bt_conn_tbl[APP_BT_MAX_CONN];
+
+/* Stack of free table indices so that entries are claimed and released in
+ * constant time */
+static uint8_t app_bt_conn_free_list[APP_BT_MAX_CONN];
+static uint8_t app_bt_conn_free_count = 0;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_init()
+***************************************************************************************************
+* Summary:
+*   This function marks all connection entries as free. It is called once when the BT stack
+*   is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_init(void)
+{
+    memset(app_bt_conn_tbl, 0, sizeof(app_bt_conn_tbl));
+
+    for (int i = 0; i < APP_BT_MAX_CONN; i++)
+    {
+        app_bt_conn_free_list[i] = (uint8_t)(APP_BT_MAX_CONN - 1 - i);
+    }
+    app_bt_conn_free_count = APP_BT_MAX_CONN;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_open()
+***************************************************************************************************
+* Summary:
+*   This function claims a connection entry for a newly connected peer and resets its state
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*   wiced_bt_ble_address_type_t addr_type : Peer device address type
+*
+* Return:
+*   Pointer to the connection entry, or NULL if all entries are in use
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_open(uint16_t conn_id, wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type)
+{
+    app_bt_conn_t *p_conn = NULL;
+
+    if ((conn_id == 0) || (app_bt_conn_free_count == 0))
+    {
+        return NULL;
+    }
+
+    p_conn = &app_bt_conn_tbl[app_bt_conn_free_list[--app_bt_conn_free_count]];
+    memset(p_conn, 0, sizeof(app_bt_conn_t));
+    p_conn->conn_id = conn_id;
+    memcpy(p_conn->bd_addr, bd_addr, sizeof(wiced_bt_device_address_t));
+    p_conn->addr_type = addr_type;
+    p_conn->mtu = APP_BT_CONN_DEFAULT_MTU;
+    p_conn->connect_ms = app_time_ms();
+
+    return p_conn;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_close()
+***************************************************************************************************
+* Summary:
+*   This function releases the connection entry of a disconnected peer
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_close(uint16_t conn_id)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+
+    if (p_conn != NULL)
+    {
+        p_conn->conn_id = 0;
+        app_bt_conn_free_list[app_bt_conn_free_count++] = app_bt_conn_index(p_conn);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry for a connection ID. The search is bounded by
+*   APP_BT_MAX_CONN
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the connection is not known
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get(uint16_t conn_id)
+{
+    if (conn_id == 0)
+    {
+        return NULL;
+    }
+
+    for (int i = 0; i < APP_BT_MAX_CONN; i++)
+    {
+        if (app_bt_conn_tbl[i].conn_id == conn_id)
+        {
+            return &app_bt_conn_tbl[i];
+        }
+    }
+    return NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_by_bd_addr()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry for a peer address, for BTM events that do not
+*   carry a connection ID. The search is bounded by APP_BT_MAX_CONN
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the peer is not connected
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get_by_bd_addr(wiced_bt_device_address_t bd_addr)
+{
+    for (int i = 0; i < APP_BT_MAX_CONN; i++)
+    {
+        if ((app_bt_conn_tbl[i].conn_id != 0) &&
+            (memcmp(app_bt_conn_tbl[i].bd_addr, bd_addr, sizeof(wiced_bt_device_address_t)) == 0))
+        {
+            return &app_bt_conn_tbl[i];
+        }
+    }
+    return NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_by_index()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry stored at a table index, for iterating over all
+*   active connections
+*
+* Parameters:
+*   uint8_t index                       : Table index, 0 to APP_BT_MAX_CONN - 1
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the entry is not in use
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get_by_index(uint8_t index)
+{
+    if ((index >= APP_BT_MAX_CONN) || (app_bt_conn_tbl[index].conn_id == 0))
+    {
+        return NULL;
+    }
+    return &app_bt_conn_tbl[index];
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_index()
+***************************************************************************************************
+* Summary:
+*   This function returns the table index of a connection entry. Modules keeping their own
+*   per-connection arrays use it as the array index
+*
+* Parameters:
+*   const app_bt_conn_t *p_conn         : Connection entry
+*
+* Return:
+*   Table index, 0 to APP_BT_MAX_CONN - 1
+*
+**************************************************************************************************/
+uint8_t app_bt_conn_index(const app_bt_conn_t *p_conn)
+{
+    return (uint8_t)(p_conn - app_bt_conn_tbl);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_count()
+***************************************************************************************************
+* Summary:
+*   This function returns the number of connected clients
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Number of connection entries in use
+*
+**************************************************************************************************/
+uint8_t app_bt_conn_count(void)
+{
+    return (uint8_t)(APP_BT_MAX_CONN - app_bt_conn_free_count);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_set_mtu()
+***************************************************************************************************
+* Summary:
+*   This function records the result of an MTU exchange. The negotiated MTU is the smaller of
+*   the client's receive MTU and the local max_mtu_size
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t peer_mtu                   : Receive MTU sent by the client
+*
+* Return:
+*   The negotiated MTU
+*
+**************************************************************************************************/
+uint16_t app_bt_conn_set_mtu(uint16_t conn_id, uint16_t peer_mtu)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+    uint16_t mtu = (peer_mtu < APP_BT_LOCAL_MAX_MTU) ? peer_mtu : APP_BT_LOCAL_MAX_MTU;
+
+    /* A client may not go below the default MTU */
+    if (mtu < APP_BT_CONN_DEFAULT_MTU)
+    {
+        mtu = APP_BT_CONN_DEFAULT_MTU;
+    }
+
+    if (p_conn != NULL)
+    {
+        p_conn->mtu = mtu;
+    }
+    return mtu;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_mtu()
+***************************************************************************************************
+* Summary:
+*   This function returns the ATT_MTU in effect on a connection
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   The negotiated MTU, or APP_BT_CONN_DEFAULT_MTU if the connection is not known
+*
+**************************************************************************************************/
+uint16_t app_bt_conn_get_mtu(uint16_t conn_id)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+
+    return (p_conn != NULL) ? p_conn->mtu : APP_BT_CONN_DEFAULT_MTU;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,240 @@
+/*******************************************************************************
+* File Name: app_bt_conn.h
+*
+* Description: Header file for per-connection state kept by the application
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BT_CONN_H_
+#define APP_BT_CONN_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_gatt.h"
+#include "app_bt_cfg.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* ATT_MTU in effect until the client performs an MTU exchange */
+#define APP_BT_CONN_DEFAULT_MTU         (23u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* State kept for each connected GATT client. A conn_id of zero marks an
+ * unused entry */
+typedef struct
+{
+    uint16_t                    conn_id;
+    wiced_bt_device_address_t   bd_addr;
+    wiced_bt_ble_address_type_t addr_type;
+    uint16_t                    mtu;
+    uint8_t                     alert_level;    /* Last IAS alert level written by this client */
+    uint32_t                    connect_ms;     /* app_time_ms() when the link came up */
+    wiced_bool_t                bonded;         /* Peer was bonded on connection and has not paired again */
+    uint8_t                     conn_profile;   /* app_bt_conn_param_profile_t last requested */
+    uint16_t                    conn_interval;  /* Granted interval, 1.25 ms units; 0 until updated */
+    uint16_t                    conn_latency;   /* Granted slave latency */
+    uint16_t                    conn_timeout;   /* Granted supervision timeout, 10 ms units */
+} app_bt_conn_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_bt_conn_init()
+***************************************************************************************************
+* Summary:
+*   This function marks all connection entries as free. It is called once when the BT stack
+*   is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_init(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_open()
+***************************************************************************************************
+* Summary:
+*   This function claims a connection entry for a newly connected peer and resets its state
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*   wiced_bt_ble_address_type_t addr_type : Peer device address type
+*
+* Return:
+*   Pointer to the connection entry, or NULL if all entries are in use
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_open(uint16_t conn_id, wiced_bt_device_address_t bd_addr, wiced_bt_ble_address_type_t addr_type);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_close()
+***************************************************************************************************
+* Summary:
+*   This function releases the connection entry of a disconnected peer
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_close(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry for a connection ID
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the connection is not known
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_by_bd_addr()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry for a peer address
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the peer is not connected
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get_by_bd_addr(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_by_index()
+***************************************************************************************************
+* Summary:
+*   This function returns the connection entry stored at a table index, for iterating over all
+*   active connections
+*
+* Parameters:
+*   uint8_t index                       : Table index, 0 to APP_BT_MAX_CONN - 1
+*
+* Return:
+*   Pointer to the connection entry, or NULL if the entry is not in use
+*
+**************************************************************************************************/
+app_bt_conn_t *app_bt_conn_get_by_index(uint8_t index);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_index()
+***************************************************************************************************
+* Summary:
+*   This function returns the table index of a connection entry. Modules keeping their own
+*   per-connection arrays use it as the array index
+*
+* Parameters:
+*   const app_bt_conn_t *p_conn         : Connection entry
+*
+* Return:
+*   Table index, 0 to APP_BT_MAX_CONN - 1
+*
+**************************************************************************************************/
+uint8_t app_bt_conn_index(const app_bt_conn_t *p_conn);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_count()
+***************************************************************************************************
+* Summary:
+*   This function returns the number of connected clients
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Number of connection entries in use
+*
+**************************************************************************************************/
+uint8_t app_bt_conn_count(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_set_mtu()
+***************************************************************************************************
+* Summary:
+*   This function records the result of an MTU exchange. The negotiated MTU is the smaller of
+*   the client's receive MTU and the local max_mtu_size
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t peer_mtu                   : Receive MTU sent by the client
+*
+* Return:
+*   The negotiated MTU
+*
+**************************************************************************************************/
+uint16_t app_bt_conn_set_mtu(uint16_t conn_id, uint16_t peer_mtu);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_get_mtu()
+***************************************************************************************************
+* Summary:
+*   This function returns the ATT_MTU in effect on a connection
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   The negotiated MTU, or APP_BT_CONN_DEFAULT_MTU if the connection is not known
+*
+**************************************************************************************************/
+uint16_t app_bt_conn_get_mtu(uint16_t conn_id);
+
+/* Largest attribute value that fits in a Read / Read Blob response (opcode only) */
+#define app_bt_conn_max_read_len(conn_id)       (app_bt_conn_get_mtu(conn_id) - 1u)
+
+#endif /* APP_BT_CONN_H_ */
@@ -0,0 +1,273 @@
+/*******************************************************************************
+* File Name: app_bt_conn_param.c
+*
+* Description: Source file for the connection parameter manager, which switches each link
+*              between an idle and an alert connection parameter profile
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_bt_l2c.h"
+#include "wiced_timer.h"
+#include "app_bt_conn_param.h"
+#include "app_time.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Idle profile: 360-450 ms interval, the peripheral may skip 3 events, 6 s timeout.
+ * Intervals are in units of 1.25 ms and the supervision timeout in units of 10 ms */
+#define APP_BT_CONN_PARAM_IDLE_MIN_INTERVAL     (288u)
+#define APP_BT_CONN_PARAM_IDLE_MAX_INTERVAL     (360u)
+#define APP_BT_CONN_PARAM_IDLE_LATENCY          (3u)
+#define APP_BT_CONN_PARAM_IDLE_TIMEOUT          (600u)
+
+/* Alert profile: 30-50 ms interval, no latency, 2 s timeout */
+#define APP_BT_CONN_PARAM_ALERT_MIN_INTERVAL    (24u)
+#define APP_BT_CONN_PARAM_ALERT_MAX_INTERVAL    (40u)
+#define APP_BT_CONN_PARAM_ALERT_LATENCY         (0u)
+#define APP_BT_CONN_PARAM_ALERT_TIMEOUT         (200u)
+
+/* A new link is moved to the idle profile only after this delay, so service
+ * discovery and the MTU exchange run at the central's own faster interval */
+#define APP_BT_CONN_PARAM_IDLE_DELAY_MS         (5000u)
+
+/* Accessory guidelines of common centrals: (1 + latency) * max interval must
+ * not exceed 2 s, and the supervision timeout must exceed three times that */
+#define APP_BT_CONN_PARAM_EFFECTIVE_VALID(max_interval, latency) \
+    ((1u + (latency)) * (max_interval) * 5u <= 2000u * 4u)
+#define APP_BT_CONN_PARAM_TIMEOUT_VALID(max_interval, latency, timeout) \
+    ((timeout) * 40u > (1u + (latency)) * (max_interval) * 15u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef struct
+{
+    uint16_t min_interval;
+    uint16_t max_interval;
+    uint16_t latency;
+    uint16_t timeout;
+} app_bt_conn_param_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static const app_bt_conn_param_t app_bt_conn_param_profiles[] =
+{
+    [APP_BT_CONN_PARAM_DEFAULT] = { 0, 0, 0, 0 },
+    [APP_BT_CONN_PARAM_IDLE]    = { APP_BT_CONN_PARAM_IDLE_MIN_INTERVAL,  APP_BT_CONN_PARAM_IDLE_MAX_INTERVAL,
+                                    APP_BT_CONN_PARAM_IDLE_LATENCY,       APP_BT_CONN_PARAM_IDLE_TIMEOUT },
+    [APP_BT_CONN_PARAM_ALERT]   = { APP_BT_CONN_PARAM_ALERT_MIN_INTERVAL, APP_BT_CONN_PARAM_ALERT_MAX_INTERVAL,
+                                    APP_BT_CONN_PARAM_ALERT_LATENCY,      APP_BT_CONN_PARAM_ALERT_TIMEOUT },
+};
+
+static wiced_timer_t app_bt_conn_param_idle_timer;
+
+_Static_assert(APP_BT_CONN_PARAM_EFFECTIVE_VALID(APP_BT_CONN_PARAM_IDLE_MAX_INTERVAL, APP_BT_CONN_PARAM_IDLE_LATENCY),
+               "Idle profile effective interval exceeds 2 s");
+_Static_assert(APP_BT_CONN_PARAM_EFFECTIVE_VALID(APP_BT_CONN_PARAM_ALERT_MAX_INTERVAL, APP_BT_CONN_PARAM_ALERT_LATENCY),
+               "Alert profile effective interval exceeds 2 s");
+
+_Static_assert(APP_BT_CONN_PARAM_TIMEOUT_VALID(APP_BT_CONN_PARAM_IDLE_MAX_INTERVAL,
+                    APP_BT_CONN_PARAM_IDLE_LATENCY, APP_BT_CONN_PARAM_IDLE_TIMEOUT),
+               "Idle profile supervision timeout too short");
+_Static_assert(APP_BT_CONN_PARAM_TIMEOUT_VALID(APP_BT_CONN_PARAM_ALERT_MAX_INTERVAL,
+                    APP_BT_CONN_PARAM_ALERT_LATENCY, APP_BT_CONN_PARAM_ALERT_TIMEOUT),
+               "Alert profile supervision timeout too short");
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_idle_timeout()
+***************************************************************************************************
+* Summary:
+*   This function requests the idle profile for links that have been up for
+*   APP_BT_CONN_PARAM_IDLE_DELAY_MS without one being requested, and restarts the timer for
+*   links that are younger
+*
+* Parameters:
+*   uint32_t arg                        : Unused
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_bt_conn_param_idle_timeout(uint32_t arg)
+{
+    uint32_t now_ms = app_time_ms();
+    uint32_t next_ms = 0;
+
+    for (uint8_t i = 0; i < APP_BT_MAX_CONN; i++)
+    {
+        app_bt_conn_t *p_conn = app_bt_conn_get_by_index(i);
+        uint32_t age_ms = 0;
+
+        if ((p_conn == NULL) || (p_conn->conn_profile != APP_BT_CONN_PARAM_DEFAULT))
+        {
+            continue;
+        }
+
+        age_ms = now_ms - p_conn->connect_ms;
+        if (age_ms >= APP_BT_CONN_PARAM_IDLE_DELAY_MS)
+        {
+            app_bt_conn_param_set_profile(p_conn, APP_BT_CONN_PARAM_IDLE);
+        }
+        else if ((next_ms == 0) || (APP_BT_CONN_PARAM_IDLE_DELAY_MS - age_ms < next_ms))
+        {
+            next_ms = APP_BT_CONN_PARAM_IDLE_DELAY_MS - age_ms;
+        }
+    }
+
+    if (next_ms != 0)
+    {
+        wiced_start_timer(&app_bt_conn_param_idle_timer, next_ms);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_init()
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer that moves new links to the idle profile. It is called
+*   once when the BT stack is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_init(void)
+{
+    wiced_init_timer(&app_bt_conn_param_idle_timer, app_bt_conn_param_idle_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function schedules the idle profile for a new link after APP_BT_CONN_PARAM_IDLE_DELAY_MS
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the new link
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_on_connect(app_bt_conn_t *p_conn)
+{
+    /* A running timer fires for an older link first and is then restarted
+     * for this one */
+    if ((p_conn != NULL) && !wiced_is_timer_in_use(&app_bt_conn_param_idle_timer))
+    {
+        wiced_start_timer(&app_bt_conn_param_idle_timer, APP_BT_CONN_PARAM_IDLE_DELAY_MS);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_set_profile()
+***************************************************************************************************
+* Summary:
+*   This function requests the connection parameters of a profile for a link, unless that
+*   profile is already the one requested
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the link
+*   app_bt_conn_param_profile_t profile : Profile to switch to
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_set_profile(app_bt_conn_t *p_conn, app_bt_conn_param_profile_t profile)
+{
+    const app_bt_conn_param_t *p_param = &app_bt_conn_param_profiles[profile];
+
+    if ((p_conn == NULL) || (profile == APP_BT_CONN_PARAM_DEFAULT) || (p_conn->conn_profile == profile))
+    {
+        return;
+    }
+
+    /* Sent as an L2CAP connection parameter update request; the central
+     * decides and reports the outcome in BTM_BLE_CONNECTION_PARAM_UPDATE */
+    if (wiced_bt_l2cap_update_ble_conn_params(p_conn->bd_addr, p_param->min_interval, p_param->max_interval,
+                                              p_param->latency, p_param->timeout))
+    {
+        p_conn->conn_profile = (uint8_t)profile;
+    }
+
+    WICED_BT_TRACE("Conn %d: requested profile %d\n\r", p_conn->conn_id, p_conn->conn_profile);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_on_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_CONNECTION_PARAM_UPDATE and records the parameters granted
+*   by the central
+*
+* Parameters:
+*   wiced_bt_ble_connection_param_update_t *p_update : Connection parameter update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_on_update(wiced_bt_ble_connection_param_update_t *p_update)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get_by_bd_addr(p_update->bd_addr);
+
+    WICED_BT_TRACE("Conn params %B: status %d, interval %d, latency %d, timeout %d\n\r",
+            p_update->bd_addr, p_update->status, p_update->conn_interval,
+            p_update->conn_latency, p_update->supervision_timeout);
+
+    if ((p_conn != NULL) && (p_update->status == WICED_BT_SUCCESS))
+    {
+        p_conn->conn_interval = p_update->conn_interval;
+        p_conn->conn_latency = p_update->conn_latency;
+        p_conn->conn_timeout = p_update->supervision_timeout;
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,134 @@
+/*******************************************************************************
+* File Name: app_bt_conn_param.h
+*
+* Description: Header file for the connection parameter manager, which switches each link
+*              between an idle and an alert connection parameter profile
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BT_CONN_PARAM_H_
+#define APP_BT_CONN_PARAM_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "app_bt_conn.h"
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Connection parameter profiles */
+typedef enum
+{
+    /* Nothing requested yet; the link runs on the central's parameters */
+    APP_BT_CONN_PARAM_DEFAULT,
+    /* Long interval with slave latency, for a tag waiting to be found */
+    APP_BT_CONN_PARAM_IDLE,
+    /* Short interval without latency, so an alert can be stopped promptly */
+    APP_BT_CONN_PARAM_ALERT,
+} app_bt_conn_param_profile_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_init()
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer that moves new links to the idle profile. It is called
+*   once when the BT stack is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_init(void);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function schedules the idle profile for a new link after a delay, so service discovery
+*   and the MTU exchange are not slowed down by it
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the new link
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_on_connect(app_bt_conn_t *p_conn);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_set_profile()
+***************************************************************************************************
+* Summary:
+*   This function requests the connection parameters of a profile for a link, unless that
+*   profile is already the one requested
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the link
+*   app_bt_conn_param_profile_t profile : Profile to switch to
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_set_profile(app_bt_conn_t *p_conn, app_bt_conn_param_profile_t profile);
+
+/**************************************************************************************************
+* Function Name: app_bt_conn_param_on_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_CONNECTION_PARAM_UPDATE and records the parameters granted
+*   by the central
+*
+* Parameters:
+*   wiced_bt_ble_connection_param_update_t *p_update : Connection parameter update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_conn_param_on_update(wiced_bt_ble_connection_param_update_t *p_update);
+
+#endif /* APP_BT_CONN_PARAM_H_ */
@@ -49,13 +49,44 @@
 #include "app_bt_event_handler.h"
 #include "app_gatts.h"
 #include "app_bt_cfg.h"
+#include "app_bt_conn.h"
+#include "app_bt_adv.h"
+#include "app_ias.h"
+#include "app_bt_bond.h"
+#include "app_bt_conn_param.h"
+#include "app_bt_link.h"
+#include "app_buf_stats.h"
+#include "app_event_queue.h"
+#include "app_latency.h"
+#include "app_log.h"
+#include "app_power.h"
+#include "app_locator.h"
+#include "app_gatt_db_const.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Highest attribute handle covered by the handle-indexed attribute lookup,
+ * taken from the design by scripts/gen_gatt_db_const.py. The generated source
+ * fails to compile if GeneratedSource numbers the database differently */
+#define APP_GATT_DB_MAX_HANDLE          (APP_GATT_DB_CONST_MAX_HANDLE)
 
 /*******************************************************************************
 *        Variable Definitions
 *******************************************************************************/
-uint16_t bt_connection_id = 0;
 app_bt_adv_conn_mode_t app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
 
+/* Maps an attribute handle to (index + 1) of its entry in app_gatt_db_ext_attr_tbl.
+ * A value of zero means the handle is not present in the table */
+static uint16_t app_gatt_db_attr_index[APP_GATT_DB_MAX_HANDLE + 1];
+
+/* Post-write handlers, indexed by attribute handle */
+static app_bt_write_handler_t app_gatt_db_write_handler[APP_GATT_DB_MAX_HANDLE + 1];
+
+/* Maps an attribute handle to (index + 1) of its entry in app_gatt_db_const_tbl.
+ * A value of zero means the attribute value is not constant */
+static uint16_t app_gatt_db_const_index[APP_GATT_DB_MAX_HANDLE + 1];
+
 /*******************************************************************************
 *        External Variable Declarations
 *******************************************************************************/
@@ -64,7 +95,6 @@ app_bt_adv_conn_mode_t app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
 *        Function Prototypes
 *******************************************************************************/
 static void                   ble_app_init               (void);
-static void                   ble_app_set_advertisement_data (void);
 
 /*******************************************************************************
 *        Function Definitions
@@ -92,6 +122,8 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event, wiced
     wiced_bt_dev_ble_pairing_info_t *p_ble_info = NULL;
     wiced_bt_ble_advert_mode_t *p_adv_mode = NULL;
 
+    APP_LATENCY_BEGIN();
+
     switch (event)
     {
         case BTM_ENABLED_EVT:
@@ -116,15 +148,18 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event, wiced
 
             /* Advertisement State Changed */
             p_adv_mode = &p_event_data->ble_advert_state_changed;
-            WICED_BT_TRACE("Advertisement State Change: %d\n\r", *p_adv_mode);
+            APP_LOG1(APP_LOG_ID_ADV_STATE, *p_adv_mode);
+
+            /* Let the scheduler account the phase and resume after a timeout */
+            app_bt_adv_on_state_changed(*p_adv_mode, (app_bt_conn_count() != 0) ? WICED_TRUE : WICED_FALSE);
 
             if (BTM_BLE_ADVERT_OFF == *p_adv_mode)
             {
                 /* Advertisement Stopped */
-                WICED_BT_TRACE("Advertisement stopped\n\r");
+                APP_LOG0(APP_LOG_ID_ADV_STOPPED);
 
                 /* Check connection status after advertisement stops */
-                if(bt_connection_id == 0)
+                if(app_bt_conn_count() == 0)
                 {
                     app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_OFF;
                 }
@@ -135,21 +170,126 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event, wiced
             }
             else
             {
-                /* Advertisement Started */
-                WICED_BT_TRACE("Advertisement started\n\r");
-                app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
+                /* Advertisement Started, possibly alongside connected clients */
+                APP_LOG0(APP_LOG_ID_ADV_STARTED);
+                if(app_bt_conn_count() == 0)
+                {
+                    app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
+                }
+                else
+                {
+                    app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_ON;
+                }
             }
 
             /* Update Advertisement LED to reflect the updated state */
-            adv_led_update();
+            app_event_signal(APP_EVENT_ADV_LED_UPDATE);
+
+            break;
+
+        case BTM_SECURITY_REQUEST_EVT:
+
+            /* Accept pairing from bonded peers, and from new peers while
+             * that cannot replace an existing bond */
+            if (app_bt_bond_pairing_allowed(p_event_data->security_request.bd_addr))
+            {
+                app_bt_conn_t *p_conn = app_bt_conn_get_by_bd_addr(p_event_data->security_request.bd_addr);
+
+                /* Encryption on this link comes from pairing, not from stored keys */
+                if (p_conn != NULL)
+                {
+                    p_conn->bonded = WICED_FALSE;
+                }
+                wiced_bt_ble_security_grant(p_event_data->security_request.bd_addr, WICED_BT_SUCCESS);
+            }
+            else
+            {
+                WICED_BT_TRACE("Pairing refused: bond table full and pairing window closed\n\r");
+                wiced_bt_ble_security_grant(p_event_data->security_request.bd_addr, WICED_BT_ERROR);
+            }
+            break;
+
+        case BTM_PAIRING_IO_CAPABILITIES_BLE_REQUEST_EVT:
+
+            /* No display or keyboard: Just Works with LE Secure Connections and bonding */
+            p_event_data->pairing_io_capabilities_ble_request.local_io_cap = BTM_IO_CAPABILITIES_NONE;
+            p_event_data->pairing_io_capabilities_ble_request.oob_data = BTM_OOB_NONE;
+            p_event_data->pairing_io_capabilities_ble_request.auth_req = BTM_LE_AUTH_REQ_SC_BOND;
+            p_event_data->pairing_io_capabilities_ble_request.max_key_size = 16;
+            p_event_data->pairing_io_capabilities_ble_request.init_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+            p_event_data->pairing_io_capabilities_ble_request.resp_keys = BTM_LE_KEY_PENC | BTM_LE_KEY_PID;
+            break;
+
+        case BTM_PAIRING_COMPLETE_EVT:
+
+            p_ble_info = &p_event_data->pairing_complete.pairing_complete_info.ble;
+            WICED_BT_TRACE("Pairing Complete: %d, reason %d\n\r", p_ble_info->status, p_ble_info->reason);
+            break;
+
+        case BTM_ENCRYPTION_STATUS_EVT:
+
+            APP_LOG_BDA1(APP_LOG_ID_ENCRYPTION, p_event_data->encryption_status.bd_addr, p_event_data->encryption_status.result);
+
+            if (WICED_BT_SUCCESS == p_event_data->encryption_status.result)
+            {
+                app_bt_conn_t *p_conn = app_bt_conn_get_by_bd_addr(p_event_data->encryption_status.bd_addr);
 
+                /* Only links resumed with stored keys; a first pairing
+                 * stores its keys before the encryption status arrives */
+                if ((p_conn != NULL) && p_conn->bonded)
+                {
+                    app_bt_bond_on_encrypted(p_conn->bd_addr, p_conn->connect_ms);
+                }
+            }
+            break;
+
+        case BTM_PAIRED_DEVICE_LINK_KEYS_UPDATE_EVT:
+
+            /* Persist the keys of a new bond. A peer pairing again may have
+             * been reset, so its cached handles are discovered again */
+            status = app_bt_bond_save_link_keys(&p_event_data->paired_device_link_keys_update);
+            app_locator_forget(p_event_data->paired_device_link_keys_update.bd_addr);
+            break;
+
+        case BTM_PAIRED_DEVICE_LINK_KEYS_REQUEST_EVT:
+
+            /* Served from the RAM cache; an error makes the stack pair again */
+            status = app_bt_bond_get_link_keys(&p_event_data->paired_device_link_keys_request);
+            break;
+
+        case BTM_LOCAL_IDENTITY_KEYS_UPDATE_EVT:
+
+            status = app_bt_bond_save_local_keys(&p_event_data->local_identity_keys_update);
+            break;
+
+        case BTM_LOCAL_IDENTITY_KEYS_REQUEST_EVT:
+
+            /* An error makes the stack generate new local keys */
+            status = app_bt_bond_get_local_keys(&p_event_data->local_identity_keys_request);
+            break;
+
+        case BTM_BLE_CONNECTION_PARAM_UPDATE:
+
+            /* Record the parameters the central granted */
+            app_bt_conn_param_on_update(&p_event_data->ble_connection_param_update);
+            break;
+
+        case BTM_BLE_PHY_UPDATE_EVT:
+
+            app_bt_link_on_phy_update(&p_event_data->ble_phy_update_event);
+            break;
+
+        case BTM_BLE_DATA_LENGTH_UPDATE_EVENT:
+
+            app_bt_link_on_data_length_update(&p_event_data->ble_data_length_update_event);
             break;
 
         default:
-            WICED_BT_TRACE("Unhandled Bluetooth Management Event: 0x%x (%d)\n\r", event, event);
+            APP_LOG2(APP_LOG_ID_MGMT_UNHANDLED, event, event);
             break;
     }
 
+    APP_LATENCY_END(APP_LATENCY_SITE_MANAGEMENT, event);
     return status;
 }
 
@@ -173,14 +313,41 @@ wiced_result_t app_bt_management_callback(wiced_bt_management_evt_t event, wiced
 *************************************************************************************************/
 static void ble_app_init(void)
 {
+    /* Prepare the retry of application event drains */
+    app_event_queue_init();
+
     /* User interface initialization for LEDs, buttons */
     app_user_interface_init();
 
-    /* Disable pairing for this application */
-    wiced_bt_set_pairable_mode(WICED_FALSE, 0);
+    /* Reset the per-connection state table */
+    app_bt_conn_init();
+
+    /* Prepare the delayed switch of new links to the idle profile */
+    app_bt_conn_param_init();
+
+    /* Start sampling the buffer pools, if enabled */
+    app_buf_stats_init();
+
+    /* Let the device sleep whenever the application is idle, if enabled */
+    app_power_init();
 
-    /* Set Advertisement Data */
-    ble_app_set_advertisement_data();
+    /* Load the bond table before the stack asks for keys */
+    app_bt_bond_init();
+
+    /* Load the locator's discovery cache, kept per bond slot */
+    app_locator_init();
+
+    /* Allow pairing; BTM_SECURITY_REQUEST_EVT decides which peers may bond */
+    wiced_bt_set_pairable_mode(WICED_TRUE, 0);
+
+    /* Set Advertisement and Scan Response Data */
+    app_bt_adv_set_data();
+
+    /* Build the attribute lookup index before any GATT request can arrive */
+    app_gatt_db_index_init();
+
+    /* Let the service modules register their write handlers */
+    app_ias_init();
 
     /* Register with BT stack to receive GATT callback */
     wiced_bt_gatt_register(app_gatt_event_callback);
@@ -189,76 +356,134 @@ static void ble_app_init(void)
     wiced_bt_gatt_db_init(gatt_database, gatt_database_len);
 
     /* Start Undirected LE Advertisements on device startup.
-     * The corresponding parameters are contained in 'app_bt_cfg.c' */
-    wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+     * The duty phase is chosen by the advertising policy */
+    app_bt_adv_start();
 }
 
 /**************************************************************************************************
-* Function Name: ble_app_set_advertisement_data()
+* Function Name: app_get_attribute()
 ***************************************************************************************************
 * Summary:
-*   This function configures the advertisement packet data
+*   This function returns attribute lookup pointer by given handle
 *
 * Parameters:
-*   None
+*   uint16_t attr_handle                    : Attribute handle for read operation
 *
 * Return:
-*   None
+*   NULL if handle not found, otherwise, it returns pointer to the attribute lookup item
 *
 **************************************************************************************************/
-static void ble_app_set_advertisement_data(void)
+gatt_db_lookup_table_t * app_get_attribute(uint16_t handle)
 {
-    wiced_bt_ble_advert_elem_t adv_elem[3] = { 0 };
-    uint8_t adv_flag = BTM_BLE_GENERAL_DISCOVERABLE_FLAG | BTM_BLE_BREDR_NOT_SUPPORTED;
-    uint8_t adv_appearance[] = { BIT16_TO_8( APPEARANCE_GENERIC_KEYRING ) };
-    uint8_t num_elem = 0;
-
-    /* Advertisement Element for Flags */
-    adv_elem[num_elem].advert_type = BTM_BLE_ADVERT_TYPE_FLAG;
-    adv_elem[num_elem].len = sizeof(uint8_t);
-    adv_elem[num_elem].p_data = &adv_flag;
-    num_elem++;
-
-    /* Advertisement Element for Name */
-    adv_elem[num_elem].advert_type = BTM_BLE_ADVERT_TYPE_NAME_COMPLETE;
-    adv_elem[num_elem].len = app_gap_device_name_len;
-    adv_elem[num_elem].p_data = app_gap_device_name;
-    num_elem++;
-
-    /* Advertisement Element for Appearance */
-    adv_elem[num_elem].advert_type = BTM_BLE_ADVERT_TYPE_APPEARANCE;
-    adv_elem[num_elem].len = sizeof(adv_appearance);
-    adv_elem[num_elem].p_data = adv_appearance;
-    num_elem++;
-
-    /* Set Raw Advertisement Data */
-    wiced_bt_ble_set_raw_advertisement_data(num_elem, adv_elem);
+    uint16_t entry = 0;
+
+    /* Constant time lookup; every handle of the database is covered */
+    if (handle <= APP_GATT_DB_MAX_HANDLE)
+    {
+        entry = app_gatt_db_attr_index[handle];
+    }
+    return (entry != 0) ? &app_gatt_db_ext_attr_tbl[entry - 1] : NULL;
 }
 
 /**************************************************************************************************
-* Function Name: app_get_attribute()
+* Function Name: app_gatt_db_index_init()
 ***************************************************************************************************
 * Summary:
-*   This function returns attribute lookup pointer by given handle
+*   This function builds the handle-indexed lookup used by app_get_attribute(). It must be called
+*   once before the GATT database is registered with the BT stack
 *
 * Parameters:
-*   uint16_t attr_handle                    : Attribute handle for read operation
+*   None
 *
 * Return:
-*   NULL if handle not found, otherwise, it returns pointer to the attribute lookup item
+*   None
 *
 **************************************************************************************************/
-gatt_db_lookup_table_t * app_get_attribute(uint16_t handle)
+void app_gatt_db_index_init(void)
 {
-    /* Check for a matching handle entry */
+    memset(app_gatt_db_attr_index, 0, sizeof(app_gatt_db_attr_index));
+
+    /* Handles above APP_GATT_DB_MAX_HANDLE fail the build in app_gatt_db_const.c;
+     * the range check only guards against a hand-edited GeneratedSource */
     for (int i = 0; i < app_gatt_db_ext_attr_tbl_size; i++)
     {
-        if (app_gatt_db_ext_attr_tbl[i].handle == handle)
+        uint16_t handle = app_gatt_db_ext_attr_tbl[i].handle;
+
+        if (handle <= APP_GATT_DB_MAX_HANDLE)
         {
-            return &app_gatt_db_ext_attr_tbl[i];
+            app_gatt_db_attr_index[handle] = (uint16_t)(i + 1);
+        }
+        else
+        {
+            WICED_BT_TRACE("Attribute handle 0x%x outside lookup index\n\r", handle);
+        }
+    }
+
+    memset(app_gatt_db_const_index, 0, sizeof(app_gatt_db_const_index));
+    for (int i = 0; i < app_gatt_db_const_tbl_size; i++)
+    {
+        uint16_t handle = app_gatt_db_const_tbl[i].handle;
+
+        if (handle <= APP_GATT_DB_MAX_HANDLE)
+        {
+            app_gatt_db_const_index[handle] = (uint16_t)(i + 1);
         }
     }
-    return NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_gatt_db_get_const()
+***************************************************************************************************
+* Summary:
+*   This function returns the flash-resident value of an attribute that never changes at
+*   runtime. Such values are generated from cycfg_bt.cybt into app_gatt_db_const_tbl
+*
+* Parameters:
+*   uint16_t handle                    : Attribute handle
+*   uint16_t *p_len                    : Set to the length of the constant value
+*
+* Return:
+*   NULL if the attribute value is not constant, otherwise a pointer to its constant value
+*
+**************************************************************************************************/
+const uint8_t *app_gatt_db_get_const(uint16_t handle, uint16_t *p_len)
+{
+    const app_gatt_db_const_t *p_const;
+
+    if ((handle > APP_GATT_DB_MAX_HANDLE) || (app_gatt_db_const_index[handle] == 0))
+    {
+        return NULL;
+    }
+    p_const = &app_gatt_db_const_tbl[app_gatt_db_const_index[handle] - 1];
+    *p_len = p_const->len;
+    return p_const->p_data;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_register_write_handler()
+***************************************************************************************************
+* Summary:
+*   This function registers the post-write handler of an attribute. Application modules use it
+*   to own the side effects of writes to their characteristics
+*
+* Parameters:
+*   uint16_t handle                    : Attribute handle, at most APP_GATT_DB_MAX_HANDLE
+*   app_bt_write_handler_t handler     : Handler to call after a write, or NULL to remove it
+*
+* Return:
+*   WICED_TRUE if the handler was registered, WICED_FALSE if the handle is out of range
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_register_write_handler(uint16_t handle, app_bt_write_handler_t handler)
+{
+    if (handle > APP_GATT_DB_MAX_HANDLE)
+    {
+        WICED_BT_TRACE("Cannot register write handler for handle 0x%x\n\r", handle);
+        return WICED_FALSE;
+    }
+
+    app_gatt_db_write_handler[handle] = handler;
+    return WICED_TRUE;
 }
 
 /**************************************************************************************************
@@ -270,6 +495,7 @@ gatt_db_lookup_table_t * app_get_attribute(uint16_t handle)
 *   whose starting address is passed as one of the function parameters
 *
 * Parameters:
+*   uint16_t conn_id                   : Connection ID of the client performing the write
 *   uint16_t handle                    : Attribute handle for write operation
 *   uint16_t offset                    : attribute offset to write
 *   uint8_t *buffer                    : Pointer to the buffer that stores the data to be written
@@ -279,7 +505,7 @@ gatt_db_lookup_table_t * app_get_attribute(uint16_t handle)
 *   wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
 *
 **************************************************************************************************/
-wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t handle, uint16_t offset, uint8_t *p_val, uint16_t len)
+wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t conn_id, uint16_t handle, uint16_t offset, uint8_t *p_val, uint16_t len)
 {
     gatt_db_lookup_table_t *p_attribute = app_get_attribute(handle);
     wiced_bt_gatt_status_t res = WICED_BT_GATT_INVALID_HANDLE;
@@ -291,16 +517,10 @@ wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t handle, uint16_t offse
             memcpy(p_attribute->p_data + offset, p_val, len);
             res = WICED_BT_GATT_SUCCESS;
 
-            /* Add code for any action required when this attribute is written.
-             * In this case, we update the IAS led based on the IAS alert
-             * level characteristic value */
-
-            switch ( handle )
+            /* Run the action registered for this attribute, if any */
+            if ((handle <= APP_GATT_DB_MAX_HANDLE) && (app_gatt_db_write_handler[handle] != NULL))
             {
-                case HDLC_IAS_ALERT_LEVEL_VALUE:
-                    WICED_BT_TRACE("Alert Level = %d\n\r", app_ias_alert_level[0]);
-                    ias_led_update();
-                    break;
+                app_gatt_db_write_handler[handle](conn_id, handle, offset, len);
             }
         }
         else
@@ -332,40 +552,94 @@ wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t handle, uint16_t offse
 wiced_bt_gatt_status_t app_bt_event_connect(wiced_bt_gatt_connection_status_t *p_conn_status)
 {
     wiced_bt_gatt_status_t status = WICED_BT_GATT_ERROR;
+    app_bt_conn_t *p_conn = NULL;
+    app_event_t event = { 0 };
 
     if ( NULL != p_conn_status )
     {
+        if ( app_locator_on_connection_status(p_conn_status) )
+        {
+            /* Link opened by the locator role to a bonded peer; it is not a
+             * Find Me client of the tag */
+            return WICED_BT_GATT_SUCCESS;
+        }
+
         if ( p_conn_status->connected )
         {
             /* Device has connected */
-            WICED_BT_TRACE("Connected : BDA '%B', Connection ID '%d'\n\r", p_conn_status->bd_addr, p_conn_status->conn_id );
+            APP_LOG_BDA1(APP_LOG_ID_CONNECTED, p_conn_status->bd_addr, p_conn_status->conn_id);
+
+            /* Claim a per-connection state entry for this client */
+            p_conn = app_bt_conn_open(p_conn_status->conn_id, p_conn_status->bd_addr, p_conn_status->addr_type);
+            if (p_conn != NULL)
+            {
+                /* Update the adv/conn state. The controller has stopped
+                 * advertising; set first, so a restart for another client
+                 * below is reported through the advertising state change */
+                app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_ON;
+                app_bt_adv_on_connect();
 
-            /* Store the connection ID */
-            bt_connection_id = p_conn_status->conn_id;
+                /* Ask a bonded client to re-encrypt with the stored keys */
+                p_conn->bonded = app_bt_bond_on_connect(p_conn_status->bd_addr);
 
-            /* Update the adv/conn state */
-            app_bt_adv_conn_state = APP_BT_ADV_OFF_CONN_ON;
+                /* Idle until a client asks for an alert, once discovery is done */
+                app_bt_conn_param_on_connect(p_conn);
+
+                /* Move to 2M PHY and long LL packets for larger transfers */
+                app_bt_link_on_connect(p_conn);
+            }
+            else
+            {
+                APP_LOG0(APP_LOG_ID_NO_CONN_ENTRY);
+                wiced_bt_gatt_disconnect(p_conn_status->conn_id);
+            }
         }
         else
         {
             /* Device has disconnected */
-            WICED_BT_TRACE("Disconnected : BDA '%B', Connection ID '%d', Reason '%d'\n\r", p_conn_status->bd_addr, p_conn_status->conn_id, p_conn_status->reason );
+            APP_LOG_BDA2(APP_LOG_ID_DISCONNECTED, p_conn_status->bd_addr, p_conn_status->conn_id, p_conn_status->reason);
+
+            /* Drop any prepared writes the peer left pending */
+            app_gatt_prep_write_clear(p_conn_status->conn_id);
 
-            /* Set the connection id to zero to indicate disconnected state */
-            bt_connection_id = 0;
+            /* Withdraw this client's alert; others may still hold theirs */
+            app_ias_on_disconnect(app_bt_conn_get(p_conn_status->conn_id));
 
-            /* Restart the advertisements */
-            wiced_bt_start_advertisements(BTM_BLE_ADVERT_UNDIRECTED_HIGH, 0, NULL);
+            /* Report the link statistics, then release the connection entry. The
+             * buffer pool and latency reports are long, so they are traced after
+             * this callback */
+            app_bt_link_on_disconnect(p_conn_status->conn_id);
+            app_event_signal(APP_EVENT_BUF_STATS_DUMP);
+            app_event_signal(APP_EVENT_LATENCY_DUMP);
+            app_bt_conn_close(p_conn_status->conn_id);
 
-            /* Update the adv/conn state */
-            app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
+            /* Restart the advertisements once the last client has gone */
+            if (app_bt_conn_count() == 0)
+            {
+                event.id = APP_EVENT_ADV_RESTART;
+                event.addr_type = (uint8_t)p_conn_status->addr_type;
+                event.arg = p_conn_status->reason;
+                memcpy(event.bd_addr, p_conn_status->bd_addr, sizeof(wiced_bt_device_address_t));
+                app_event_post(&event);
+
+                /* Update the adv/conn state */
+                app_bt_adv_conn_state = APP_BT_ADV_ON_CONN_OFF;
+            }
+            else
+            {
+                /* A slot has been freed: resume advertising if it had
+                 * stopped at the connection limit */
+                event.id = APP_EVENT_ADV_RESTART;
+                app_event_post(&event);
+            }
 
-            /* Turn Off the IAS LED on a disconnection */
-            ias_led_update();
+            /* Re-evaluate the IAS LED against the clients still connected */
+            app_event_signal(APP_EVENT_IAS_LED_UPDATE);
         }
 
-        /* Update the advertisement LED to reflect updated state */
-        adv_led_update();
+        /* Update the advertisement LED to reflect updated state. LED and
+         * advertising work runs after this callback returns */
+        app_event_signal(APP_EVENT_ADV_LED_UPDATE);
 
         status = WICED_BT_GATT_SUCCESS;
     }
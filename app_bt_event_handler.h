@@ -59,9 +59,14 @@ typedef enum
 {
     APP_BT_ADV_OFF_CONN_OFF,
     APP_BT_ADV_ON_CONN_OFF,
-    APP_BT_ADV_OFF_CONN_ON
+    APP_BT_ADV_OFF_CONN_ON,
+    APP_BT_ADV_ON_CONN_ON
 } app_bt_adv_conn_mode_t;
 
+/* Post-write handler registered for an attribute handle. It is called after the
+ * written value has been stored in the GATT database */
+typedef void (*app_bt_write_handler_t)(uint16_t conn_id, uint16_t handle, uint16_t offset, uint16_t len);
+
 /*******************************************************************************
 *        External Variable Declarations
 *******************************************************************************/
@@ -99,6 +104,7 @@ wiced_bt_gatt_status_t app_bt_event_connect       (wiced_bt_gatt_connection_stat
 *   whose starting address is passed as one of the function parameters
 *
 * Parameters:
+*   uint16_t conn_id                   : Connection ID of the client performing the write
 *   uint16_t handle                    : Attribute handle for write operation
 *   uint16_t offset                    : attribute offset to write
 *   uint8_t *buffer                    : Pointer to the buffer that stores the data to be written
@@ -108,7 +114,24 @@ wiced_bt_gatt_status_t app_bt_event_connect       (wiced_bt_gatt_connection_stat
 *   wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
 *
 **************************************************************************************************/
-wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t handle, uint16_t offset, uint8_t *buff, uint16_t len);
+wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t conn_id, uint16_t handle, uint16_t offset, uint8_t *buff, uint16_t len);
+
+/**************************************************************************************************
+* Function Name: app_bt_register_write_handler()
+***************************************************************************************************
+* Summary:
+*   This function registers the post-write handler of an attribute. Application modules use it
+*   to own the side effects of writes to their characteristics
+*
+* Parameters:
+*   uint16_t handle                    : Attribute handle
+*   app_bt_write_handler_t handler     : Handler to call after a write, or NULL to remove it
+*
+* Return:
+*   WICED_TRUE if the handler was registered, WICED_FALSE if the handle is out of range
+*
+**************************************************************************************************/
+wiced_bool_t app_bt_register_write_handler(uint16_t handle, app_bt_write_handler_t handler);
 
 /**************************************************************************************************
 * Function Name: app_get_attribute()
@@ -125,4 +148,37 @@ wiced_bt_gatt_status_t app_bt_write_handle_value(uint16_t handle, uint16_t offse
 **************************************************************************************************/
 gatt_db_lookup_table_t * app_get_attribute(uint16_t handle);
 
+/**************************************************************************************************
+* Function Name: app_gatt_db_index_init()
+***************************************************************************************************
+* Summary:
+*   This function builds the handle-indexed lookup used by app_get_attribute(). It must be called
+*   once before the GATT database is registered with the BT stack
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_gatt_db_index_init(void);
+
+/**************************************************************************************************
+* Function Name: app_gatt_db_get_const()
+***************************************************************************************************
+* Summary:
+*   This function returns the flash-resident value of an attribute that never changes at
+*   runtime. Such values are generated from cycfg_bt.cybt into app_gatt_db_const_tbl
+*
+* Parameters:
+*   uint16_t handle                    : Attribute handle
+*   uint16_t *p_len                    : Set to the length of the constant value
+*
+* Return:
+*   NULL if the attribute value is not constant, otherwise a pointer to its constant value
+*
+**************************************************************************************************/
+const uint8_t *app_gatt_db_get_const(uint16_t handle, uint16_t *p_len);
+
 #endif /* APP_BT_EVENT_HANDLER_H_ */
@@ -0,0 +1,339 @@
+/*******************************************************************************
+* File Name: app_bt_link.c
+*
+* Description: Source file for link layer tuning: LE 2M PHY and data length negotiation,
+*              with per-connection goodput statistics
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "app_bt_link.h"
+#include "app_time.h"
+#include "app_log.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* LL payload size before a data length update */
+#define APP_BT_LINK_DEFAULT_OCTETS      (27u)
+
+/* HCI PHY value of LE 1M, which every link starts on */
+#define APP_BT_LINK_PHY_1M              (1u)
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Indexed like the connection table */
+static app_bt_link_stats_t app_bt_link_stats[APP_BT_MAX_CONN];
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_bt_link_get()
+***************************************************************************************************
+* Summary:
+*   This function returns the link statistics entry of a connection
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry, may be NULL
+*
+* Return:
+*   Pointer to the statistics entry, or NULL if p_conn is NULL
+*
+**************************************************************************************************/
+static app_bt_link_stats_t *app_bt_link_get(app_bt_conn_t *p_conn)
+{
+    return (p_conn != NULL) ? &app_bt_link_stats[app_bt_conn_index(p_conn)] : NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_account()
+***************************************************************************************************
+* Summary:
+*   This function updates the transfer timing of a link for a new PDU. The gap to the previous
+*   PDU counts as busy time when both belong to the same transfer
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry
+*   app_bt_link_stats_t *p_stats        : Link statistics entry of the connection
+*   uint16_t len                        : Payload length
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_bt_link_account(app_bt_conn_t *p_conn, app_bt_link_stats_t *p_stats, uint16_t len)
+{
+    uint32_t now_ms = app_time_ms();
+    uint32_t gap_ms = now_ms - p_stats->last_pdu_ms;
+    uint32_t burst_gap_ms = (2u * p_conn->conn_interval * 5u) / 4u;
+
+    if (burst_gap_ms < APP_BT_LINK_BURST_GAP_MS)
+    {
+        burst_gap_ms = APP_BT_LINK_BURST_GAP_MS;
+    }
+
+    if ((p_stats->last_pdu_ms != 0) && (gap_ms < burst_gap_ms))
+    {
+        p_stats->busy_ms += gap_ms;
+        p_stats->burst_bytes += len;
+    }
+    p_stats->last_pdu_ms = now_ms;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function resets the link statistics of a new connection and asks the controller for
+*   LE 2M PHY and the maximum data length
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the link
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_connect(app_bt_conn_t *p_conn)
+{
+    app_bt_link_stats_t *p_stats = app_bt_link_get(p_conn);
+    wiced_bt_ble_phy_preferences_t phy_preferences;
+
+    if (p_stats == NULL)
+    {
+        return;
+    }
+
+    memset(p_stats, 0, sizeof(app_bt_link_stats_t));
+    p_stats->tx_phy = APP_BT_LINK_PHY_1M;
+    p_stats->rx_phy = APP_BT_LINK_PHY_1M;
+    p_stats->max_tx_octets = APP_BT_LINK_DEFAULT_OCTETS;
+    p_stats->max_rx_octets = APP_BT_LINK_DEFAULT_OCTETS;
+
+    /* A peer without 2M support keeps the link on 1M; the outcome is
+     * reported in BTM_BLE_PHY_UPDATE_EVT */
+    memcpy(phy_preferences.remote_bd_addr, p_conn->bd_addr, sizeof(wiced_bt_device_address_t));
+    phy_preferences.tx_phys = BTM_BLE_PREFER_2M_PHY;
+    phy_preferences.rx_phys = BTM_BLE_PREFER_2M_PHY;
+    phy_preferences.phy_opts = BTM_BLE_PREFER_NO_LELR;
+    wiced_bt_ble_set_phy(&phy_preferences);
+
+    /* Fill the ACL buffers with one LL packet instead of ten 27 byte ones */
+    wiced_bt_ble_set_data_packet_length(p_conn->bd_addr, APP_BT_LINK_MAX_TX_OCTETS, APP_BT_LINK_MAX_TX_TIME_US);
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function reports the link statistics of a connection that is closing
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_disconnect(uint16_t conn_id)
+{
+    const app_bt_link_stats_t *p_stats = app_bt_link_get_stats(conn_id);
+
+    if (p_stats != NULL)
+    {
+        /* Runs in the disconnect callback; with APP_BINARY_LOG this is two
+         * ring records rather than a formatted UART write */
+        APP_LOG4(APP_LOG_ID_LINK_SETTINGS, conn_id, p_stats->tx_phy, p_stats->rx_phy, p_stats->max_tx_octets);
+        APP_LOG4(APP_LOG_ID_LINK_TRAFFIC, conn_id, p_stats->tx_bytes, p_stats->rx_bytes,
+                app_bt_link_goodput_bps(conn_id));
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_phy_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_PHY_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_ble_phy_update_t *p_update : PHY update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_phy_update(wiced_bt_ble_phy_update_t *p_update)
+{
+    app_bt_link_stats_t *p_stats = app_bt_link_get(app_bt_conn_get_by_bd_addr(p_update->bd_address));
+
+    WICED_BT_TRACE("PHY update %B: status %d, tx %d, rx %d\n\r",
+            p_update->bd_address, p_update->status, p_update->tx_phy, p_update->rx_phy);
+
+    if ((p_stats != NULL) && (p_update->status == WICED_BT_SUCCESS))
+    {
+        p_stats->tx_phy = p_update->tx_phy;
+        p_stats->rx_phy = p_update->rx_phy;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_data_length_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_DATA_LENGTH_UPDATE_EVENT
+*
+* Parameters:
+*   wiced_bt_ble_data_length_update_t *p_update : Data length update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_data_length_update(wiced_bt_ble_data_length_update_t *p_update)
+{
+    app_bt_link_stats_t *p_stats = app_bt_link_get(app_bt_conn_get_by_bd_addr(p_update->bd_address));
+
+    WICED_BT_TRACE("Data length update %B: tx %d, rx %d octets\n\r",
+            p_update->bd_address, p_update->max_tx_octets, p_update->max_rx_octets);
+
+    if (p_stats != NULL)
+    {
+        p_stats->max_tx_octets = p_update->max_tx_octets;
+        p_stats->max_rx_octets = p_update->max_rx_octets;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_tx()
+***************************************************************************************************
+* Summary:
+*   This function accounts ATT payload sent on a link
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t len                        : Payload length
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_tx(uint16_t conn_id, uint16_t len)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+    app_bt_link_stats_t *p_stats = app_bt_link_get(p_conn);
+
+    if (p_stats != NULL)
+    {
+        p_stats->tx_bytes += len;
+        app_bt_link_account(p_conn, p_stats, len);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_rx()
+***************************************************************************************************
+* Summary:
+*   This function accounts ATT payload received on a link
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t len                        : Payload length
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_rx(uint16_t conn_id, uint16_t len)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+    app_bt_link_stats_t *p_stats = app_bt_link_get(p_conn);
+
+    if (p_stats != NULL)
+    {
+        p_stats->rx_bytes += len;
+        app_bt_link_account(p_conn, p_stats, len);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the link statistics of a connection
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   Pointer to the statistics, or NULL if the connection is not known
+*
+**************************************************************************************************/
+const app_bt_link_stats_t *app_bt_link_get_stats(uint16_t conn_id)
+{
+    return app_bt_link_get(app_bt_conn_get(conn_id));
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_link_goodput_bps()
+***************************************************************************************************
+* Summary:
+*   This function returns the goodput of a connection measured over its transfers
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   ATT payload bits per second, or 0 if nothing has been measured yet
+*
+**************************************************************************************************/
+uint32_t app_bt_link_goodput_bps(uint16_t conn_id)
+{
+    const app_bt_link_stats_t *p_stats = app_bt_link_get_stats(conn_id);
+
+    if ((p_stats == NULL) || (p_stats->busy_ms == 0))
+    {
+        return 0;
+    }
+    return (uint32_t)(((uint64_t)p_stats->burst_bytes * 8000u) / p_stats->busy_ms);
+}
+
+/* [] END OF FILE */
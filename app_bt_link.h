@@ -0,0 +1,206 @@
+/*******************************************************************************
+* File Name: app_bt_link.h
+*
+* Description: Header file for link layer tuning: LE 2M PHY and data length negotiation,
+*              with per-connection goodput statistics
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BT_LINK_H_
+#define APP_BT_LINK_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+#include "app_bt_conn.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* LL data length requested after connecting; the Bluetooth 5 maximum */
+#define APP_BT_LINK_MAX_TX_OCTETS       (251u)
+#define APP_BT_LINK_MAX_TX_TIME_US      (2120u)
+
+/* PDUs closer together than this (or than two connection intervals, if
+ * longer) belong to the same transfer when measuring goodput */
+#define APP_BT_LINK_BURST_GAP_MS        (100u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Negotiated link layer settings and traffic of one connection */
+typedef struct
+{
+    uint8_t  tx_phy;                /* HCI PHY as reported by BTM_BLE_PHY_UPDATE_EVT: 1 = 1M, 2 = 2M, 3 = Coded */
+    uint8_t  rx_phy;
+    uint16_t max_tx_octets;         /* LL payload bytes per packet, 27 until updated */
+    uint16_t max_rx_octets;
+    uint32_t tx_bytes;              /* ATT payload sent: read responses */
+    uint32_t rx_bytes;              /* ATT payload received: writes */
+    uint32_t burst_bytes;           /* Payload that followed another PDU within the burst gap */
+    uint32_t busy_ms;               /* Time spent on those bursts */
+    uint32_t last_pdu_ms;           /* app_time_ms() of the last PDU */
+} app_bt_link_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_bt_link_on_connect()
+***************************************************************************************************
+* Summary:
+*   This function resets the link statistics of a new connection and asks the controller for
+*   LE 2M PHY and the maximum data length
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the link
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_connect(app_bt_conn_t *p_conn);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function reports the link statistics of a connection that is closing
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_disconnect(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_phy_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_PHY_UPDATE_EVT
+*
+* Parameters:
+*   wiced_bt_ble_phy_update_t *p_update : PHY update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_phy_update(wiced_bt_ble_phy_update_t *p_update);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_data_length_update()
+***************************************************************************************************
+* Summary:
+*   This function handles BTM_BLE_DATA_LENGTH_UPDATE_EVENT
+*
+* Parameters:
+*   wiced_bt_ble_data_length_update_t *p_update : Data length update event data
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_data_length_update(wiced_bt_ble_data_length_update_t *p_update);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_tx()
+***************************************************************************************************
+* Summary:
+*   This function accounts ATT payload sent on a link
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t len                        : Payload length
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_tx(uint16_t conn_id, uint16_t len);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_on_rx()
+***************************************************************************************************
+* Summary:
+*   This function accounts ATT payload received on a link
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*   uint16_t len                        : Payload length
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_bt_link_on_rx(uint16_t conn_id, uint16_t len);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the link statistics of a connection
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   Pointer to the statistics, or NULL if the connection is not known
+*
+**************************************************************************************************/
+const app_bt_link_stats_t *app_bt_link_get_stats(uint16_t conn_id);
+
+/**************************************************************************************************
+* Function Name: app_bt_link_goodput_bps()
+***************************************************************************************************
+* Summary:
+*   This function returns the goodput of a connection measured over its transfers
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID reported by the BT stack
+*
+* Return:
+*   ATT payload bits per second, or 0 if nothing has been measured yet
+*
+**************************************************************************************************/
+uint32_t app_bt_link_goodput_bps(uint16_t conn_id);
+
+#endif /* APP_BT_LINK_H_ */
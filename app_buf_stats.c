@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name: app_buf_stats.c
+*
+* Description: Source file for the buffer pool instrumentation: per-pool usage, high-water
+*              marks and exhaustion counts, with a recommended wiced_bt_cfg_buf_pools table
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifdef APP_BUF_POOL_STATS
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_memory.h"
+#include "wiced_timer.h"
+#include "app_bt_cfg.h"
+#include "app_buf_stats.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Sampling period of the pool usage */
+#ifndef APP_BUF_STATS_SAMPLE_MS
+#define APP_BUF_STATS_SAMPLE_MS         (1000u)
+#endif
+
+/* Headroom added to the observed peak in the recommended table */
+#ifndef APP_BUF_STATS_MARGIN_PCT
+#define APP_BUF_STATS_MARGIN_PCT        (25u)
+#endif
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+typedef struct
+{
+    uint16_t in_use;            /* Buffers allocated at the last sample */
+    uint16_t peak;              /* Most buffers ever allocated, as reported by the stack */
+    uint32_t exhausted;         /* Samples that found every buffer allocated */
+} app_buf_stats_pool_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static wiced_timer_t        app_buf_stats_timer;
+static app_buf_stats_pool_t app_buf_stats_pool[WICED_BT_CFG_NUM_BUF_POOLS];
+static uint32_t             app_buf_stats_samples = 0;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void app_buf_stats_timer_cb(uint32_t arg);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_init()
+***************************************************************************************************
+* Summary:
+*   This function starts sampling the buffer pools periodically
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_init(void)
+{
+    wiced_init_timer(&app_buf_stats_timer, app_buf_stats_timer_cb, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    wiced_start_timer(&app_buf_stats_timer, APP_BUF_STATS_SAMPLE_MS);
+}
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_timer_cb()
+***************************************************************************************************
+* Summary:
+*   This function is the periodic sampling timer callback
+*
+* Parameters:
+*   uint32_t arg                        : Unused
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_buf_stats_timer_cb(uint32_t arg)
+{
+    app_buf_stats_sample();
+}
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_sample()
+***************************************************************************************************
+* Summary:
+*   This function reads the current buffer pool usage and updates the statistics. It is also
+*   worth calling right after a burst of traffic, between two periodic samples
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_sample(void)
+{
+    wiced_bt_buffer_statistics_t usage[WICED_BT_CFG_NUM_BUF_POOLS];
+
+    if (wiced_bt_get_buffer_usage(usage, sizeof(usage)) != WICED_BT_SUCCESS)
+    {
+        return;
+    }
+
+    app_buf_stats_samples++;
+    for (int i = 0; i < WICED_BT_CFG_NUM_BUF_POOLS; i++)
+    {
+        app_buf_stats_pool[i].in_use = usage[i].current_allocated_count;
+
+        /* The stack keeps the peak itself, so allocations between samples are not missed */
+        if (usage[i].max_allocated_count > app_buf_stats_pool[i].peak)
+        {
+            app_buf_stats_pool[i].peak = usage[i].max_allocated_count;
+        }
+
+        /* An allocation from a full pool spills into the next pool or fails */
+        if ((usage[i].total_count != 0) && (usage[i].current_allocated_count >= usage[i].total_count))
+        {
+            app_buf_stats_pool[i].exhausted++;
+        }
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_dump()
+***************************************************************************************************
+* Summary:
+*   This function traces the statistics of each pool followed by a recommended pool table
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_dump(void)
+{
+    uint16_t count = 0;
+
+    app_buf_stats_sample();
+
+    WICED_BT_TRACE("Buffer pools after %d samples:\n\r", app_buf_stats_samples);
+    for (int i = 0; i < WICED_BT_CFG_NUM_BUF_POOLS; i++)
+    {
+        WICED_BT_TRACE("  pool %d (%d bytes): in use %d, peak %d of %d, exhausted %d\n\r",
+                i, wiced_bt_cfg_buf_pools[i].buf_size, app_buf_stats_pool[i].in_use,
+                app_buf_stats_pool[i].peak, wiced_bt_cfg_buf_pools[i].buf_count, app_buf_stats_pool[i].exhausted);
+    }
+
+    /* Peak plus margin, which may be below the configured count; a pool
+     * that ran full gives no upper bound, so it is doubled instead. A pool
+     * the session never allocated from, e.g. the large one that only long
+     * attribute values need, says nothing about its size and keeps its
+     * configured count */
+    WICED_BT_TRACE("Recommended wiced_bt_cfg_buf_pools:\n\r");
+    for (int i = 0; i < WICED_BT_CFG_NUM_BUF_POOLS; i++)
+    {
+        if (app_buf_stats_pool[i].peak == 0)
+        {
+            WICED_BT_TRACE("    { %d, %d },    /* not exercised */\n\r",
+                    wiced_bt_cfg_buf_pools[i].buf_size, wiced_bt_cfg_buf_pools[i].buf_count);
+            continue;
+        }
+
+        if (app_buf_stats_pool[i].peak >= wiced_bt_cfg_buf_pools[i].buf_count)
+        {
+            count = (uint16_t)(2u * wiced_bt_cfg_buf_pools[i].buf_count);
+        }
+        else
+        {
+            count = (uint16_t)((app_buf_stats_pool[i].peak * (100u + APP_BUF_STATS_MARGIN_PCT) + 99u) / 100u);
+        }
+
+        WICED_BT_TRACE("    { %d, %d },%s\n\r", wiced_bt_cfg_buf_pools[i].buf_size, count,
+                (app_buf_stats_pool[i].exhausted != 0) ? "    /* ran out */" : "");
+    }
+}
+
+#endif /* APP_BUF_POOL_STATS */
+
+/* [] END OF FILE */
@@ -0,0 +1,109 @@
+/*******************************************************************************
+* File Name: app_buf_stats.h
+*
+* Description: Header file for the buffer pool instrumentation: per-pool usage, high-water
+*              marks and exhaustion counts, with a recommended wiced_bt_cfg_buf_pools table
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_BUF_STATS_H_
+#define APP_BUF_STATS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced.h"
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#ifdef APP_BUF_POOL_STATS
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_init()
+***************************************************************************************************
+* Summary:
+*   This function starts sampling the buffer pools periodically
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_init(void);
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_sample()
+***************************************************************************************************
+* Summary:
+*   This function reads the current buffer pool usage and updates the statistics. It is also
+*   worth calling right after a burst of traffic, between two periodic samples
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_sample(void);
+
+/**************************************************************************************************
+* Function Name: app_buf_stats_dump()
+***************************************************************************************************
+* Summary:
+*   This function traces the statistics of each pool followed by a recommended pool table
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_buf_stats_dump(void);
+
+#else
+
+#define app_buf_stats_init()
+#define app_buf_stats_sample()
+#define app_buf_stats_dump()
+
+#endif /* APP_BUF_POOL_STATS */
+
+#endif /* APP_BUF_STATS_H_ */
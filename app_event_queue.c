@@ -0,0 +1,394 @@
+/*******************************************************************************
+* File Name: app_event_queue.c
+*
+* Description: Source file for the application event queue, which defers work out of the
+*              Bluetooth stack callbacks to a serialized application callback
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_rtos.h"
+#include "wiced_timer.h"
+#include "app_event_queue.h"
+#include "app_bt_conn.h"
+#include "app_bt_adv.h"
+#include "app_user_interface.h"
+#include "app_locator.h"
+#include "app_buf_stats.h"
+#include "app_latency.h"
+#include "app_log.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define APP_EVENT_QUEUE_MASK            (APP_EVENT_QUEUE_DEPTH - 1u)
+
+/* Delay before draining from the retry timer when wiced_app_event_serialize() fails */
+#define APP_EVENT_QUEUE_RETRY_MS        (10u)
+
+_Static_assert((APP_EVENT_QUEUE_DEPTH & APP_EVENT_QUEUE_MASK) == 0, "APP_EVENT_QUEUE_DEPTH must be a power of two");
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Single producer (stack callbacks), single consumer (the serialized drain).
+ * Only the producer writes head and only the consumer writes tail; both run
+ * freely and wrap through the mask */
+static app_event_t              app_event_ring[APP_EVENT_QUEUE_DEPTH];
+static volatile uint8_t         app_event_head = 0;
+static volatile uint8_t         app_event_tail = 0;
+
+/* One byte per signal, so raising and clearing never share a read-modify-write */
+static volatile uint8_t         app_event_pending[APP_EVENT_NUM_SIGNALS];
+
+/* Set while a drain is requested and has not started yet */
+static volatile wiced_bool_t    app_event_scheduled = WICED_FALSE;
+
+/* Drains the queue when the stack could not serialize the request */
+static wiced_timer_t            app_event_retry_timer;
+static wiced_bool_t             app_event_retry_ready = WICED_FALSE;
+
+static app_event_queue_stats_t  app_event_queue_stats;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static int app_event_queue_drain(void *p_data);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_event_queue_schedule()
+***************************************************************************************************
+* Summary:
+*   This function requests a drain of the queue from the application context, unless one is
+*   already requested
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_event_queue_schedule(void)
+{
+    if (!app_event_scheduled)
+    {
+        app_event_scheduled = WICED_TRUE;
+        if (wiced_app_event_serialize(app_event_queue_drain, NULL) != WICED_SUCCESS)
+        {
+            /* Left to a later signal or post, the events would keep
+             * app_event_queue_idle() false and the device awake until then.
+             * The timer drains them instead; scheduled stays set until it does */
+            if (app_event_retry_ready)
+            {
+                app_event_queue_stats.retries++;
+                wiced_start_timer(&app_event_retry_timer, APP_EVENT_QUEUE_RETRY_MS);
+            }
+            else
+            {
+                app_event_scheduled = WICED_FALSE;
+            }
+        }
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_event_dispatch()
+***************************************************************************************************
+* Summary:
+*   This function performs the work of one event
+*
+* Parameters:
+*   const app_event_t *p_event          : Event to handle
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_event_dispatch(const app_event_t *p_event)
+{
+    switch (p_event->id)
+    {
+        case APP_EVENT_ADV_LED_UPDATE:
+            adv_led_update();
+            break;
+
+        case APP_EVENT_IAS_LED_UPDATE:
+            ias_led_update();
+            break;
+
+        case APP_EVENT_BUTTON:
+            app_locator_toggle();
+            break;
+
+        case APP_EVENT_BUF_STATS_DUMP:
+            app_buf_stats_dump();
+            break;
+
+        case APP_EVENT_LATENCY_DUMP:
+            app_latency_dump();
+            break;
+
+        case APP_EVENT_LOG_DRAIN:
+            app_log_drain();
+            break;
+
+        case APP_EVENT_ADV_RESTART:
+            /* Clients may have connected or disconnected since the event was queued */
+            if (app_bt_conn_count() == 0)
+            {
+                app_bt_adv_on_disconnect(p_event->arg, (uint8_t *)p_event->bd_addr, (wiced_bt_ble_address_type_t)p_event->addr_type);
+            }
+            else
+            {
+                app_bt_adv_update_connected();
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_event_queue_drain()
+***************************************************************************************************
+* Summary:
+*   This function is the serialized application callback. It handles the queued events in order,
+*   then the pending signals, so the LEDs reflect the state left by the queued events
+*
+* Parameters:
+*   void *p_data                        : Unused
+*
+* Return:
+*   0
+*
+**************************************************************************************************/
+static int app_event_queue_drain(void *p_data)
+{
+    app_event_t event = { 0 };
+
+    APP_LATENCY_BEGIN();
+
+    /* Cleared first: anything raised from here on schedules another drain */
+    app_event_scheduled = WICED_FALSE;
+    app_event_queue_stats.drains++;
+
+    while (app_event_tail != app_event_head)
+    {
+        app_event_dispatch(&app_event_ring[app_event_tail & APP_EVENT_QUEUE_MASK]);
+        app_event_tail++;
+    }
+
+    for (uint8_t id = 0; id < APP_EVENT_NUM_SIGNALS; id++)
+    {
+        if (app_event_pending[id])
+        {
+            app_event_pending[id] = 0;
+            event.id = id;
+            app_event_dispatch(&event);
+        }
+    }
+
+    APP_LATENCY_END(APP_LATENCY_SITE_EVENT_QUEUE, 0);
+    return 0;
+}
+
+/**************************************************************************************************
+* Function Name: app_event_queue_retry()
+***************************************************************************************************
+* Summary:
+*   This function drains the queue after wiced_app_event_serialize() failed. Timer callbacks run
+*   in the application thread, like the serialized drain
+*
+* Parameters:
+*   uint32_t arg                        : Unused
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_event_queue_retry(uint32_t arg)
+{
+    app_event_queue_drain(NULL);
+}
+
+/**************************************************************************************************
+* Function Name: app_event_queue_init()
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer that retries a drain the stack could not serialize. It is
+*   called once when the BT stack is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_event_queue_init(void)
+{
+    wiced_init_timer(&app_event_retry_timer, app_event_queue_retry, 0, WICED_MILLI_SECONDS_TIMER);
+    app_event_retry_ready = WICED_TRUE;
+}
+
+/**************************************************************************************************
+* Function Name: app_event_signal()
+***************************************************************************************************
+* Summary:
+*   This function raises a signal event. It only sets a flag and returns, so it is safe to call
+*   from a Bluetooth stack callback
+*
+* Parameters:
+*   app_event_id_t id                   : Signal, below APP_EVENT_NUM_SIGNALS
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_event_signal(app_event_id_t id)
+{
+    if (id >= APP_EVENT_NUM_SIGNALS)
+    {
+        return;
+    }
+
+    app_event_queue_stats.signalled++;
+    if (app_event_pending[id])
+    {
+        app_event_queue_stats.coalesced++;
+    }
+    app_event_pending[id] = 1;
+
+    app_event_queue_schedule();
+}
+
+/**************************************************************************************************
+* Function Name: app_event_post()
+***************************************************************************************************
+* Summary:
+*   This function queues an event with its data. It only copies the event into the ring and
+*   returns, so it is safe to call from a Bluetooth stack callback
+*
+* Parameters:
+*   const app_event_t *p_event          : Event to queue
+*
+* Return:
+*   WICED_TRUE if queued, WICED_FALSE if the ring is full
+*
+**************************************************************************************************/
+wiced_bool_t app_event_post(const app_event_t *p_event)
+{
+    uint8_t depth = (uint8_t)(app_event_head - app_event_tail);
+
+    if (depth >= APP_EVENT_QUEUE_DEPTH)
+    {
+        app_event_queue_stats.dropped++;
+        WICED_BT_TRACE("Event queue full, dropped event %d\n\r", p_event->id);
+        return WICED_FALSE;
+    }
+
+    /* Fill the slot before publishing it through head */
+    memcpy(&app_event_ring[app_event_head & APP_EVENT_QUEUE_MASK], p_event, sizeof(app_event_t));
+    app_event_head++;
+
+    app_event_queue_stats.posted++;
+    if (depth + 1u > app_event_queue_stats.max_depth)
+    {
+        app_event_queue_stats.max_depth = (uint8_t)(depth + 1u);
+    }
+
+    app_event_queue_schedule();
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+* Function Name: app_event_queue_idle()
+***************************************************************************************************
+* Summary:
+*   This function reports whether any event is waiting to be handled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if nothing is queued, pending or scheduled
+*
+**************************************************************************************************/
+wiced_bool_t app_event_queue_idle(void)
+{
+    if (app_event_scheduled || (app_event_tail != app_event_head))
+    {
+        return WICED_FALSE;
+    }
+
+    for (uint8_t id = 0; id < APP_EVENT_NUM_SIGNALS; id++)
+    {
+        if (app_event_pending[id])
+        {
+            return WICED_FALSE;
+        }
+    }
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+* Function Name: app_event_queue_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the queue statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_event_queue_stats_t *app_event_queue_get_stats(void)
+{
+    return &app_event_queue_stats;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,179 @@
+/*******************************************************************************
+* File Name: app_event_queue.h
+*
+* Description: Header file for the application event queue, which defers work out of the
+*              Bluetooth stack callbacks to a serialized application callback
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_EVENT_QUEUE_H_
+#define APP_EVENT_QUEUE_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced.h"
+#include "wiced_bt_dev.h"
+#include "wiced_bt_ble.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Capacity of the event ring; must be a power of two */
+#define APP_EVENT_QUEUE_DEPTH           (8u)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Application events */
+typedef enum
+{
+    /* Signalled: repeated signals before the queue is serviced coalesce into one */
+    APP_EVENT_ADV_LED_UPDATE,
+    APP_EVENT_IAS_LED_UPDATE,
+    APP_EVENT_BUTTON,               /* User button released */
+    APP_EVENT_BUF_STATS_DUMP,       /* A client disconnected; report the buffer pools */
+    APP_EVENT_LATENCY_DUMP,         /* A client disconnected; report the callback latencies */
+    APP_EVENT_LOG_DRAIN,            /* Kept last, to flush what the other events logged */
+    APP_EVENT_NUM_SIGNALS,
+
+    /* Posted: queued with their data, in order */
+    APP_EVENT_ADV_RESTART = APP_EVENT_NUM_SIGNALS,  /* Last client gone; arg is the disconnect reason */
+} app_event_id_t;
+
+/* Queued event */
+typedef struct
+{
+    uint8_t                   id;           /* app_event_id_t */
+    uint8_t                   addr_type;    /* wiced_bt_ble_address_type_t of bd_addr */
+    uint16_t                  arg;
+    wiced_bt_device_address_t bd_addr;
+} app_event_t;
+
+/* Queue statistics */
+typedef struct
+{
+    uint32_t signalled;             /* Signals raised */
+    uint32_t coalesced;             /* Signals merged into one already pending */
+    uint32_t posted;                /* Events queued */
+    uint32_t dropped;               /* Events lost to a full ring */
+    uint32_t drains;                /* Serialized callbacks run */
+    uint32_t retries;               /* Drains left to the retry timer after a failed serialize */
+    uint8_t  max_depth;             /* Most events queued at once */
+} app_event_queue_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_event_queue_init()
+***************************************************************************************************
+* Summary:
+*   This function prepares the timer that retries a drain the stack could not serialize. It is
+*   called once when the BT stack is enabled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_event_queue_init(void);
+
+/**************************************************************************************************
+* Function Name: app_event_signal()
+***************************************************************************************************
+* Summary:
+*   This function raises a signal event. It only sets a flag and returns, so it is safe to call
+*   from a Bluetooth stack callback
+*
+* Parameters:
+*   app_event_id_t id                   : Signal, below APP_EVENT_NUM_SIGNALS
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_event_signal(app_event_id_t id);
+
+/**************************************************************************************************
+* Function Name: app_event_post()
+***************************************************************************************************
+* Summary:
+*   This function queues an event with its data. It only copies the event into the ring and
+*   returns, so it is safe to call from a Bluetooth stack callback
+*
+* Parameters:
+*   const app_event_t *p_event          : Event to queue
+*
+* Return:
+*   WICED_TRUE if queued, WICED_FALSE if the ring is full
+*
+**************************************************************************************************/
+wiced_bool_t app_event_post(const app_event_t *p_event);
+
+/**************************************************************************************************
+* Function Name: app_event_queue_idle()
+***************************************************************************************************
+* Summary:
+*   This function reports whether any event is waiting to be handled
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if nothing is queued, pending or scheduled
+*
+**************************************************************************************************/
+wiced_bool_t app_event_queue_idle(void);
+
+/**************************************************************************************************
+* Function Name: app_event_queue_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the queue statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_event_queue_stats_t *app_event_queue_get_stats(void);
+
+#endif /* APP_EVENT_QUEUE_H_ */
@@ -0,0 +1,24 @@
+/* This file was generated by scripts/gen_gatt_db_const.py from cycfg_bt.cybt.
+ * Do not edit; it is regenerated on every build (GATT_DB_GEN=1, the default). */
+
+#include "cycfg_gatt_db.h"
+#include "app_gatt_db_const.h"
+
+/* Fail the build when GeneratedSource numbers the database differently */
+_Static_assert(HDLS_GAP == 1, "Regenerate with GATT_DB_GEN=1");
+_Static_assert(HDLC_GAP_DEVICE_NAME_VALUE == 3, "Regenerate with GATT_DB_GEN=1");
+_Static_assert(HDLC_GAP_APPEARANCE_VALUE == 5, "Regenerate with GATT_DB_GEN=1");
+_Static_assert(HDLS_GATT == 6, "Regenerate with GATT_DB_GEN=1");
+_Static_assert(HDLS_IAS == 7, "Regenerate with GATT_DB_GEN=1");
+_Static_assert(HDLC_IAS_ALERT_LEVEL_VALUE == 9, "Regenerate with GATT_DB_GEN=1");
+
+static const uint8_t app_gap_device_name_const[] = { 0x46, 0x69, 0x6E, 0x64, 0x20, 0x4D, 0x65, 0x20, 0x54, 0x61, 0x72, 0x67, 0x65, 0x74 };
+static const uint8_t app_gap_appearance_const[] = { 0x00, 0x00 };
+
+const app_gatt_db_const_t app_gatt_db_const_tbl[] =
+{
+    { HDLC_GAP_DEVICE_NAME_VALUE, sizeof(app_gap_device_name_const), app_gap_device_name_const },
+    { HDLC_GAP_APPEARANCE_VALUE, sizeof(app_gap_appearance_const), app_gap_appearance_const },
+};
+
+const uint16_t app_gatt_db_const_tbl_size = 2;
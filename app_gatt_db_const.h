@@ -0,0 +1,27 @@
+/* This file was generated by scripts/gen_gatt_db_const.py from cycfg_bt.cybt.
+ * Do not edit; it is regenerated on every build (GATT_DB_GEN=1, the default). */
+
+#ifndef APP_GATT_DB_CONST_H_
+#define APP_GATT_DB_CONST_H_
+
+#include <stdint.h>
+
+/* Highest attribute handle in the GATT database */
+#define APP_GATT_DB_CONST_MAX_HANDLE (9u)
+
+/* Length of each constant value, usable in compile-time checks */
+#define APP_GATT_DB_CONST_GAP_DEVICE_NAME_LEN (14u)
+#define APP_GATT_DB_CONST_GAP_APPEARANCE_LEN (2u)
+
+/* Attribute value that never changes at runtime and is kept in flash */
+typedef struct
+{
+    uint16_t       handle;
+    uint16_t       len;
+    const uint8_t *p_data;
+} app_gatt_db_const_t;
+
+extern const app_gatt_db_const_t app_gatt_db_const_tbl[];
+extern const uint16_t app_gatt_db_const_tbl_size;
+
+#endif /* APP_GATT_DB_CONST_H_ */
@@ -44,6 +44,250 @@
 #include "wiced_bt_gatt.h"
 #include "wiced_bt_trace.h"
 #include "app_bt_event_handler.h"
+#include "app_bt_cfg.h"
+#include "app_bt_conn.h"
+#include "app_bt_link.h"
+#include "app_latency.h"
+#include "app_log.h"
+#include "app_locator.h"
+#include "app_gatts.h"
+
+/*******************************************************************************
+ *                                MACROS
+ ******************************************************************************/
+/* Bytes of queued prepared-write data held per connection */
+#ifndef APP_PREP_WRITE_ARENA_SIZE
+#define APP_PREP_WRITE_ARENA_SIZE       (512)
+#endif
+
+/* Number of prepared-write fragments held per connection */
+#ifndef APP_PREP_WRITE_MAX_ENTRIES
+#define APP_PREP_WRITE_MAX_ENTRIES      (16)
+#endif
+
+/*******************************************************************************
+ *                                TYPES
+ ******************************************************************************/
+/* A single queued Prepare Write fragment; the value bytes live in the arena */
+typedef struct
+{
+    uint16_t handle;
+    uint16_t offset;
+    uint16_t len;
+    uint16_t arena_offset;
+} app_prep_write_entry_t;
+
+/* Prepared-write queue of one connection. A conn_id of zero marks a free queue */
+typedef struct
+{
+    uint16_t               conn_id;
+    wiced_bool_t           overflow;
+    uint8_t                num_entries;
+    uint16_t               arena_used;
+    app_prep_write_entry_t entry[APP_PREP_WRITE_MAX_ENTRIES];
+    uint8_t                arena[APP_PREP_WRITE_ARENA_SIZE];
+} app_prep_write_queue_t;
+
+/*******************************************************************************
+ *                                VARIABLES
+ ******************************************************************************/
+static app_prep_write_queue_t app_prep_write_queue[APP_BT_MAX_CONN];
+
+/**************************************************************************************************
+* Function Name: app_prep_write_get_queue()
+***************************************************************************************************
+* Summary:
+*   This function returns the prepared-write queue of a connection, optionally claiming a free
+*   queue if the connection does not have one yet
+*
+* Parameters:
+*   uint16_t conn_id     : Connection ID
+*   wiced_bool_t alloc   : WICED_TRUE to claim a free queue when none is assigned
+*
+* Return:
+*   Pointer to the queue, or NULL if none is assigned and none could be claimed
+*
+**************************************************************************************************/
+static app_prep_write_queue_t *app_prep_write_get_queue(uint16_t conn_id, wiced_bool_t alloc)
+{
+    app_prep_write_queue_t *p_free = NULL;
+
+    for (int i = 0; i < APP_BT_MAX_CONN; i++)
+    {
+        if (app_prep_write_queue[i].conn_id == conn_id)
+        {
+            return &app_prep_write_queue[i];
+        }
+        if ((p_free == NULL) && (app_prep_write_queue[i].conn_id == 0))
+        {
+            p_free = &app_prep_write_queue[i];
+        }
+    }
+
+    if (alloc && (p_free != NULL))
+    {
+        p_free->conn_id     = conn_id;
+        p_free->overflow    = WICED_FALSE;
+        p_free->num_entries = 0;
+        p_free->arena_used  = 0;
+        return p_free;
+    }
+    return NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_gatt_prep_write_clear()
+***************************************************************************************************
+* Summary:
+*   This function discards any prepared writes queued for a connection and releases its queue.
+*   It is called when the connection goes down
+*
+* Parameters:
+*   uint16_t conn_id                            : Connection ID
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_gatt_prep_write_clear(uint16_t conn_id)
+{
+    app_prep_write_queue_t *p_queue = app_prep_write_get_queue(conn_id, WICED_FALSE);
+
+    if (p_queue != NULL)
+    {
+        p_queue->conn_id = 0;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_prep_write_handle_value()
+***************************************************************************************************
+* Summary:
+*   This function queues a Prepare Write fragment for the connection. Only the handle is checked
+*   here; offset and length errors are reported in the Execute Write Response, as the Core
+*   specification requires
+*
+* Parameters:
+*   uint16_t conn_id     : Connection ID
+*   uint16_t handle      : Attribute handle for write operation
+*   uint16_t offset      : attribute offset to write
+*   uint8_t *p_val       : Pointer to the fragment data
+*   uint16_t len         : Length of the fragment data
+*
+* Return:
+*   wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+*
+**************************************************************************************************/
+static wiced_bt_gatt_status_t app_bt_prep_write_handle_value(uint16_t conn_id, uint16_t handle, uint16_t offset, uint8_t *p_val, uint16_t len)
+{
+    gatt_db_lookup_table_t *p_attribute = app_get_attribute(handle);
+    app_prep_write_queue_t *p_queue = NULL;
+    app_prep_write_entry_t *p_entry = NULL;
+
+    if (p_attribute == NULL)
+    {
+        APP_LOG1(APP_LOG_ID_PREP_INVALID, handle);
+        return WICED_BT_GATT_INVALID_HANDLE;
+    }
+
+    p_queue = app_prep_write_get_queue(conn_id, WICED_TRUE);
+    if (p_queue == NULL)
+    {
+        return WICED_BT_GATT_PREPARE_Q_FULL;
+    }
+
+    /* Once a fragment has been rejected, the transaction can only be cancelled */
+    if ((p_queue->overflow) ||
+        (p_queue->num_entries >= APP_PREP_WRITE_MAX_ENTRIES) ||
+        (APP_PREP_WRITE_ARENA_SIZE - p_queue->arena_used < len))
+    {
+        APP_LOG1(APP_LOG_ID_PREP_FULL, conn_id);
+        p_queue->overflow = WICED_TRUE;
+        return WICED_BT_GATT_PREPARE_Q_FULL;
+    }
+
+    p_entry = &p_queue->entry[p_queue->num_entries++];
+    p_entry->handle       = handle;
+    p_entry->offset       = offset;
+    p_entry->len          = len;
+    p_entry->arena_offset = p_queue->arena_used;
+    memcpy(&p_queue->arena[p_queue->arena_used], p_val, len);
+    p_queue->arena_used += len;
+
+    return WICED_BT_GATT_SUCCESS;
+}
+
+/**************************************************************************************************
+* Function Name: app_bt_exec_write_handle_value()
+***************************************************************************************************
+* Summary:
+*   This function applies or cancels all Prepare Write fragments queued for the connection and
+*   releases the queue. Every fragment is bounds checked before any is applied, so an invalid
+*   offset or length leaves the attributes untouched. Fragments are applied in the order they
+*   were received
+*
+* Parameters:
+*   uint16_t conn_id                     : Connection ID
+*   wiced_bt_gatt_exec_flag_t exec_flag  : GATT_PREP_WRITE_EXEC or GATT_PREP_WRITE_CANCEL
+*
+* Return:
+*   wiced_bt_gatt_status_t: The first error met, for the Execute Write Response. See possible
+*   status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
+*
+**************************************************************************************************/
+static wiced_bt_gatt_status_t app_bt_exec_write_handle_value(uint16_t conn_id, wiced_bt_gatt_exec_flag_t exec_flag)
+{
+    app_prep_write_queue_t *p_queue = app_prep_write_get_queue(conn_id, WICED_FALSE);
+    wiced_bt_gatt_status_t status = WICED_BT_GATT_SUCCESS;
+    gatt_db_lookup_table_t *p_attribute = NULL;
+    app_prep_write_entry_t *p_entry = NULL;
+
+    if (p_queue == NULL)
+    {
+        /* Nothing was queued */
+        return WICED_BT_GATT_SUCCESS;
+    }
+
+    if (exec_flag == GATT_PREP_WRITE_EXEC)
+    {
+        if (p_queue->overflow)
+        {
+            status = WICED_BT_GATT_PREPARE_Q_FULL;
+        }
+
+        /* Check every fragment first, so a bad one does not leave the
+         * attributes partially updated */
+        for (int i = 0; (i < p_queue->num_entries) && (status == WICED_BT_GATT_SUCCESS); i++)
+        {
+            p_entry = &p_queue->entry[i];
+            p_attribute = app_get_attribute(p_entry->handle);
+
+            if (p_attribute == NULL)
+            {
+                status = WICED_BT_GATT_INVALID_HANDLE;
+            }
+            else if (p_entry->offset > p_attribute->max_len)
+            {
+                status = WICED_BT_GATT_INVALID_OFFSET;
+            }
+            else if (p_attribute->max_len - p_entry->offset < p_entry->len)
+            {
+                status = WICED_BT_GATT_INVALID_ATTR_LEN;
+            }
+        }
+
+        /* Apply them in order, reporting the first write that fails */
+        for (int i = 0; (i < p_queue->num_entries) && (status == WICED_BT_GATT_SUCCESS); i++)
+        {
+            p_entry = &p_queue->entry[i];
+            status = app_bt_write_handle_value(conn_id, p_entry->handle, p_entry->offset,
+                    &p_queue->arena[p_entry->arena_offset], p_entry->len);
+        }
+    }
+
+    p_queue->conn_id = 0;
+    return status;
+}
 
 /**************************************************************************************************
 * Function Name: app_bt_read_handle_value()
@@ -54,6 +298,7 @@
 *   starting address is passed as one of the function parameters
 *
 * Parameters:
+*   uint16_t conn_id    : Connection ID, used to size the response to the negotiated MTU
 *   uint16_t handle     : Attribute handle for read operation
 *   uint16_t offset     : offset to read
 *   uint8_t *buff       : Pointer to the buffer to store read data (need to make sure butter is large enough to hold len data
@@ -63,34 +308,50 @@
 *   wiced_bt_gatt_status_t: See possible status codes in wiced_bt_gatt_status_e in wiced_bt_gatt.h
 *
 **************************************************************************************************/
-static wiced_bt_gatt_status_t app_bt_read_handle_value(uint16_t handle, uint8_t offset, uint8_t *buff, uint16_t *p_len)
+static wiced_bt_gatt_status_t app_bt_read_handle_value(uint16_t conn_id, uint16_t handle, uint16_t offset, uint8_t *buff, uint16_t *p_len)
 {
     gatt_db_lookup_table_t *p_attribute = app_get_attribute(handle);
     wiced_bt_gatt_status_t res = WICED_BT_GATT_INVALID_HANDLE;
+    const uint8_t *p_value = NULL;
+    uint16_t value_len = 0;
 
     if (p_attribute != NULL)
     {
-        if (offset < p_attribute->max_len)
+        /* Constant values are served from flash rather than from their RAM copy */
+        p_value = app_gatt_db_get_const(handle, &value_len);
+        if (p_value == NULL)
+        {
+            p_value   = p_attribute->p_data;
+            value_len = p_attribute->max_len;
+        }
+
+        if (offset < value_len)
         {
+            // a single response never carries more than the negotiated MTU allows
+            if (*p_len > app_bt_conn_max_read_len(conn_id))
+            {
+                *p_len = app_bt_conn_max_read_len(conn_id);
+            }
+
             // if requested len is larger than available data, change copy length to available data
-            if (*p_len > p_attribute->max_len - offset)
+            if (*p_len > value_len - offset)
             {
-                *p_len = p_attribute->max_len - offset;
+                *p_len = value_len - offset;
             }
 
             /* Value fits within the supplied buffer; copy over the value */
-            memcpy(buff, p_attribute->p_data+offset, *p_len);
+            memcpy(buff, p_value+offset, *p_len);
             res = WICED_BT_GATT_SUCCESS;
         }
         else
         {
-            WICED_BT_TRACE("offset:%d larger than attribute length:%d", offset, p_attribute->max_len);
+            WICED_BT_TRACE("offset:%d larger than attribute length:%d", offset, value_len);
             res = WICED_BT_GATT_INVALID_OFFSET;
         }
     }
     else
     {
-        WICED_BT_TRACE("Read Request to Invalid Handle: 0x%x\n\r", handle);
+        APP_LOG1(APP_LOG_ID_READ_INVALID, handle);
     }
     return res;
 }
@@ -118,11 +379,31 @@ static wiced_bt_gatt_status_t app_gatt_req_event(uint16_t conn_id, wiced_bt_gatt
     {
         case GATTS_REQ_TYPE_READ:
             /* Attribute read request */
-            status = app_bt_read_handle_value(p_data->read_req.handle, p_data->read_req.offset, p_data->read_req.p_val, p_data->read_req.p_val_len);
+            status = app_bt_read_handle_value(conn_id, p_data->read_req.handle, p_data->read_req.offset, p_data->read_req.p_val, p_data->read_req.p_val_len);
+            if (status == WICED_BT_GATT_SUCCESS)
+            {
+                app_bt_link_on_tx(conn_id, *p_data->read_req.p_val_len);
+            }
             break;
         case GATTS_REQ_TYPE_WRITE:
             /* Attribute write request */
-            status = app_bt_write_handle_value(p_data->write_req.handle, p_data->write_req.offset, p_data->write_req.p_val, p_data->write_req.val_len);
+            status = app_bt_write_handle_value(conn_id, p_data->write_req.handle, p_data->write_req.offset, p_data->write_req.p_val, p_data->write_req.val_len);
+            app_bt_link_on_rx(conn_id, p_data->write_req.val_len);
+            break;
+        case GATTS_REQ_TYPE_PREP_WRITE:
+            /* Queue a fragment of a long or reliable write */
+            status = app_bt_prep_write_handle_value(conn_id, p_data->write_req.handle, p_data->write_req.offset, p_data->write_req.p_val, p_data->write_req.val_len);
+            app_bt_link_on_rx(conn_id, p_data->write_req.val_len);
+            break;
+        case GATTS_REQ_TYPE_WRITE_EXEC:
+            /* Apply or discard the queued fragments */
+            status = app_bt_exec_write_handle_value(conn_id, p_data->exec_write);
+            break;
+        case GATTS_REQ_TYPE_MTU:
+            /* Client MTU exchange; responses on this link are sized from the result */
+            app_bt_conn_set_mtu(conn_id, p_data->mtu);
+            APP_LOG2(APP_LOG_ID_MTU, conn_id, app_bt_conn_get_mtu(conn_id));
+            status = WICED_BT_GATT_SUCCESS;
             break;
     }
 
@@ -150,6 +431,8 @@ wiced_bt_gatt_status_t app_gatt_event_callback(wiced_bt_gatt_evt_t event, wiced_
     wiced_bt_gatt_connection_status_t *p_conn_status = NULL;
     wiced_bt_gatt_attribute_request_t *p_attr_req = NULL;
 
+    APP_LATENCY_BEGIN();
+
     /* Call the appropriate callback function based on the GATT event type, and pass the relevant event
      * parameters to the callback function */
     switch ( event )
@@ -163,10 +446,27 @@ wiced_bt_gatt_status_t app_gatt_event_callback(wiced_bt_gatt_evt_t event, wiced_
             status = app_gatt_req_event( p_attr_req->conn_id, p_attr_req->request_type, &p_attr_req->data );
             break;
 
+        /* GATT client events of the locator role */
+        case GATT_DISCOVERY_RESULT_EVT:
+            app_locator_on_discovery_result( &p_event_data->discovery_result );
+            status = WICED_BT_GATT_SUCCESS;
+            break;
+
+        case GATT_DISCOVERY_CPLT_EVT:
+            app_locator_on_discovery_complete( &p_event_data->discovery_complete );
+            status = WICED_BT_GATT_SUCCESS;
+            break;
+
+        case GATT_OPERATION_CPLT_EVT:
+            app_locator_on_operation_complete( &p_event_data->operation_complete );
+            status = WICED_BT_GATT_SUCCESS;
+            break;
+
         default:
             status = WICED_BT_GATT_SUCCESS;
             break;
     }
 
+    APP_LATENCY_END(APP_LATENCY_SITE_GATT, (p_attr_req != NULL) ? APP_LATENCY_GATT_REQ(p_attr_req->request_type) : event);
     return status;
 }
@@ -58,3 +58,19 @@
 *
 **************************************************************************************************/
 wiced_bt_gatt_status_t app_gatt_event_callback(wiced_bt_gatt_evt_t  event, wiced_bt_gatt_event_data_t *p_event_data);
+
+/**************************************************************************************************
+* Function Name: app_gatt_prep_write_clear()
+***************************************************************************************************
+* Summary:
+*   This function discards any prepared writes queued for a connection and releases its queue.
+*   It is called when the connection goes down
+*
+* Parameters:
+*   uint16_t conn_id                            : Connection ID
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_gatt_prep_write_clear(uint16_t conn_id);
@@ -0,0 +1,205 @@
+/*******************************************************************************
+* File Name: app_ias.c
+*
+* Description: Source file for the Immediate Alert Service handling
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "cycfg_gatt_db.h"
+#include "app_bt_event_handler.h"
+#include "app_bt_conn.h"
+#include "app_bt_conn_param.h"
+#include "app_event_queue.h"
+#include "app_log.h"
+#include "app_ias.h"
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Number of connected clients at each alert level above none. The output
+ * level is the highest one with a client, found in APP_IAS_ALERT_LEVELS steps
+ * whatever the number of links */
+static uint8_t app_ias_level_count[APP_IAS_ALERT_LEVELS];
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void app_ias_alert_level_write_cb(uint16_t conn_id, uint16_t handle, uint16_t offset, uint16_t len);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_ias_init()
+***************************************************************************************************
+* Summary:
+*   This function registers the Immediate Alert Service write handlers. It must be called after
+*   the attribute lookup index has been built
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_ias_init(void)
+{
+    app_bt_register_write_handler(HDLC_IAS_ALERT_LEVEL_VALUE, app_ias_alert_level_write_cb);
+}
+
+/**************************************************************************************************
+* Function Name: app_ias_set_level()
+***************************************************************************************************
+* Summary:
+*   This function moves a client from its current alert level to a new one
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the client
+*   uint8_t level                       : New alert level
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_ias_set_level(app_bt_conn_t *p_conn, uint8_t level)
+{
+    if (level >= APP_IAS_ALERT_LEVELS)
+    {
+        level = APP_IAS_ALERT_LEVELS - 1u;
+    }
+
+    if (p_conn->alert_level != 0)
+    {
+        app_ias_level_count[p_conn->alert_level]--;
+    }
+    if (level != 0)
+    {
+        app_ias_level_count[level]++;
+    }
+    p_conn->alert_level = level;
+}
+
+/**************************************************************************************************
+* Function Name: app_ias_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function withdraws the alert of a client that is disconnecting
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the client
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_ias_on_disconnect(app_bt_conn_t *p_conn)
+{
+    if (p_conn != NULL)
+    {
+        app_ias_set_level(p_conn, 0);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_ias_get_alert_level()
+***************************************************************************************************
+* Summary:
+*   This function returns the alert level to output: the highest level set by any connected
+*   client
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Alert level, below APP_IAS_ALERT_LEVELS
+*
+**************************************************************************************************/
+uint8_t app_ias_get_alert_level(void)
+{
+    for (uint8_t level = APP_IAS_ALERT_LEVELS - 1u; level > 0; level--)
+    {
+        if (app_ias_level_count[level] != 0)
+        {
+            return level;
+        }
+    }
+    return 0;
+}
+
+/**************************************************************************************************
+* Function Name: app_ias_alert_level_write_cb()
+***************************************************************************************************
+* Summary:
+*   This function is called after a client writes the IAS Alert Level characteristic. It records
+*   the level against the client, switches its connection parameter profile and updates the
+*   IAS LED with the highest level across clients
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID of the client performing the write
+*   uint16_t handle                     : Attribute handle written
+*   uint16_t offset                     : Offset of the write
+*   uint16_t len                        : Length of the write
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_ias_alert_level_write_cb(uint16_t conn_id, uint16_t handle, uint16_t offset, uint16_t len)
+{
+    app_bt_conn_t *p_conn = app_bt_conn_get(conn_id);
+
+    APP_LOG1(APP_LOG_ID_ALERT_LEVEL, app_ias_alert_level[0]);
+
+    /* Each client holds its own alert; the output is the highest of them */
+    if (p_conn != NULL)
+    {
+        app_ias_set_level(p_conn, app_ias_alert_level[0]);
+
+        /* Stay responsive while alerting, so the alert can be stopped quickly */
+        app_bt_conn_param_set_profile(p_conn, (p_conn->alert_level != 0) ? APP_BT_CONN_PARAM_ALERT : APP_BT_CONN_PARAM_IDLE);
+    }
+
+    /* Deferred; a burst of writes results in a single LED update */
+    app_event_signal(APP_EVENT_IAS_LED_UPDATE);
+}
+
+/* [] END OF FILE */
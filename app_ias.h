@@ -0,0 +1,107 @@
+/*******************************************************************************
+* File Name: app_ias.h
+*
+* Description: Header file for the Immediate Alert Service handling
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_IAS_H_
+#define APP_IAS_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "app_bt_conn.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Alert levels defined by the Immediate Alert Service; higher values written
+ * by a client are treated as the high alert */
+#define APP_IAS_ALERT_LEVELS            (3u)
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_ias_init()
+***************************************************************************************************
+* Summary:
+*   This function registers the Immediate Alert Service write handlers. It must be called after
+*   the attribute lookup index has been built
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_ias_init(void);
+
+/**************************************************************************************************
+* Function Name: app_ias_on_disconnect()
+***************************************************************************************************
+* Summary:
+*   This function withdraws the alert of a client that is disconnecting
+*
+* Parameters:
+*   app_bt_conn_t *p_conn               : Connection entry of the client
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_ias_on_disconnect(app_bt_conn_t *p_conn);
+
+/**************************************************************************************************
+* Function Name: app_ias_get_alert_level()
+***************************************************************************************************
+* Summary:
+*   This function returns the alert level to output: the highest level set by any connected
+*   client
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Alert level, below APP_IAS_ALERT_LEVELS
+*
+**************************************************************************************************/
+uint8_t app_ias_get_alert_level(void);
+
+#endif /* APP_IAS_H_ */
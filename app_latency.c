@@ -0,0 +1,200 @@
+/*******************************************************************************
+* File Name: app_latency.c
+*
+* Description: Source file for the callback latency instrumentation: cycle counter timestamps
+*              around each handler, kept as per-event log2 histograms
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifdef APP_LATENCY_STATS
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "app_latency.h"
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Last entry collects the site / code pairs that did not get their own */
+static app_latency_hist_t app_latency_hist[APP_LATENCY_MAX_KEYS + 1];
+static uint8_t            app_latency_keys = 0;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_latency_init()
+***************************************************************************************************
+* Summary:
+*   This function enables the cycle counter. It must run before the first instrumented handler
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_init(void)
+{
+    APP_LATENCY_DEMCR |= (1u << 24);        /* TRCENA */
+    APP_LATENCY_DWT_CYCCNT = 0;
+    APP_LATENCY_DWT_CTRL |= 1u;             /* CYCCNTENA */
+
+    app_latency_hist[APP_LATENCY_MAX_KEYS].site = 0xFF;
+}
+
+/**************************************************************************************************
+* Function Name: app_latency_record()
+***************************************************************************************************
+* Summary:
+*   This function adds one measured latency to the histogram of a site / code pair
+*
+* Parameters:
+*   app_latency_site_t site             : Instrumented handler
+*   uint16_t code                       : Event handled
+*   uint32_t cycles                     : Time spent in the handler
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_record(app_latency_site_t site, uint16_t code, uint32_t cycles)
+{
+    app_latency_hist_t *p_hist = &app_latency_hist[APP_LATENCY_MAX_KEYS];
+    uint8_t bucket = 0;
+    uint8_t i = 0;
+
+    for (i = 0; i < app_latency_keys; i++)
+    {
+        if ((app_latency_hist[i].site == site) && (app_latency_hist[i].code == code))
+        {
+            p_hist = &app_latency_hist[i];
+            break;
+        }
+    }
+    if ((i == app_latency_keys) && (app_latency_keys < APP_LATENCY_MAX_KEYS))
+    {
+        p_hist = &app_latency_hist[app_latency_keys++];
+        p_hist->site = (uint8_t)site;
+        p_hist->code = code;
+    }
+
+    /* floor(log2(cycles)), capped to the last bucket */
+    bucket = (cycles == 0) ? 0 : (uint8_t)(31u - __builtin_clz(cycles));
+    if (bucket >= APP_LATENCY_BUCKETS)
+    {
+        bucket = APP_LATENCY_BUCKETS - 1u;
+    }
+
+    p_hist->count++;
+    p_hist->total += cycles;
+    if (cycles > p_hist->max)
+    {
+        p_hist->max = cycles;
+    }
+    if (p_hist->bucket[bucket] != UINT16_MAX)
+    {
+        p_hist->bucket[bucket]++;
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_latency_get()
+***************************************************************************************************
+* Summary:
+*   This function returns a histogram for a command handler or debugger to read out
+*
+* Parameters:
+*   uint8_t index                       : Histogram index, from 0
+*
+* Return:
+*   Pointer to the histogram, or NULL past the last one in use
+*
+**************************************************************************************************/
+const app_latency_hist_t *app_latency_get(uint8_t index)
+{
+    if (index < app_latency_keys)
+    {
+        return &app_latency_hist[index];
+    }
+    if ((index == app_latency_keys) && (app_latency_hist[APP_LATENCY_MAX_KEYS].count != 0))
+    {
+        return &app_latency_hist[APP_LATENCY_MAX_KEYS];
+    }
+    return NULL;
+}
+
+/**************************************************************************************************
+* Function Name: app_latency_dump()
+***************************************************************************************************
+* Summary:
+*   This function traces every histogram in use
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_dump(void)
+{
+    const app_latency_hist_t *p_hist = NULL;
+
+    WICED_BT_TRACE("Callback latency (us at %d MHz):\n\r", APP_LATENCY_CPU_MHZ);
+    for (uint8_t i = 0; (p_hist = app_latency_get(i)) != NULL; i++)
+    {
+        WICED_BT_TRACE("  site %d code 0x%x: n %d, avg %d, max %d\n\r", p_hist->site, p_hist->code, p_hist->count,
+                (uint32_t)(p_hist->total / p_hist->count) / APP_LATENCY_CPU_MHZ, p_hist->max / APP_LATENCY_CPU_MHZ);
+
+        /* Non-empty buckets only, as lower bound in cycles and count */
+        for (uint8_t b = 0; b < APP_LATENCY_BUCKETS; b++)
+        {
+            if (p_hist->bucket[b] != 0)
+            {
+                WICED_BT_TRACE("    >=%d: %d\n\r", 1u << b, p_hist->bucket[b]);
+            }
+        }
+    }
+}
+
+#endif /* APP_LATENCY_STATS */
+
+/* [] END OF FILE */
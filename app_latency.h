@@ -0,0 +1,181 @@
+/*******************************************************************************
+* File Name: app_latency.h
+*
+* Description: Header file for the callback latency instrumentation: cycle counter timestamps
+*              around each handler, kept as per-event log2 histograms
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_LATENCY_H_
+#define APP_LATENCY_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced.h"
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Instrumented handlers */
+typedef enum
+{
+    APP_LATENCY_SITE_MANAGEMENT,    /* app_bt_management_callback(); code is the management event */
+    APP_LATENCY_SITE_GATT,          /* app_gatt_event_callback(); code is the GATT event, or
+                                     * APP_LATENCY_GATT_REQ(request type) for attribute requests */
+    APP_LATENCY_SITE_LED_TIMER,     /* LED blink pattern timer callback */
+    APP_LATENCY_SITE_EVENT_QUEUE,   /* Application event queue drain */
+} app_latency_site_t;
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Code of an attribute request, kept apart from the GATT event codes */
+#define APP_LATENCY_GATT_REQ(type)      (0x100u | (type))
+
+#ifdef APP_LATENCY_STATS
+
+/* Number of distinct site / code pairs tracked; later ones share an overflow entry */
+#ifndef APP_LATENCY_MAX_KEYS
+#define APP_LATENCY_MAX_KEYS            (16u)
+#endif
+
+/* Bucket i counts latencies of 2^i up to 2^(i+1) - 1 cycles; the last one is open ended */
+#define APP_LATENCY_BUCKETS             (20u)
+
+/* Core clock used to convert cycles for the trace dump */
+#ifndef APP_LATENCY_CPU_MHZ
+#define APP_LATENCY_CPU_MHZ             (96u)
+#endif
+
+/* DWT cycle counter of the Cortex-M core */
+#define APP_LATENCY_DEMCR               (*(volatile uint32_t *)0xE000EDFCu)
+#define APP_LATENCY_DWT_CTRL            (*(volatile uint32_t *)0xE0001000u)
+#define APP_LATENCY_DWT_CYCCNT          (*(volatile uint32_t *)0xE0001004u)
+
+/* Place APP_LATENCY_BEGIN() at the top of a handler and APP_LATENCY_END() before its return */
+#define APP_LATENCY_BEGIN()             uint32_t app_latency_start = APP_LATENCY_DWT_CYCCNT
+#define APP_LATENCY_END(site, code)     app_latency_record((site), (uint16_t)(code), APP_LATENCY_DWT_CYCCNT - app_latency_start)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Latency histogram of one site / code pair. Latencies are in cycles */
+typedef struct
+{
+    uint8_t  site;                  /* app_latency_site_t */
+    uint16_t code;
+    uint32_t count;
+    uint32_t max;
+    uint64_t total;
+    uint16_t bucket[APP_LATENCY_BUCKETS];   /* Saturate at 0xFFFF */
+} app_latency_hist_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+/**************************************************************************************************
+* Function Name: app_latency_init()
+***************************************************************************************************
+* Summary:
+*   This function enables the cycle counter. It must run before the first instrumented handler
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_init(void);
+
+/**************************************************************************************************
+* Function Name: app_latency_record()
+***************************************************************************************************
+* Summary:
+*   This function adds one measured latency to the histogram of a site / code pair
+*
+* Parameters:
+*   app_latency_site_t site             : Instrumented handler
+*   uint16_t code                       : Event handled
+*   uint32_t cycles                     : Time spent in the handler
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_record(app_latency_site_t site, uint16_t code, uint32_t cycles);
+
+/**************************************************************************************************
+* Function Name: app_latency_get()
+***************************************************************************************************
+* Summary:
+*   This function returns a histogram for a command handler or debugger to read out
+*
+* Parameters:
+*   uint8_t index                       : Histogram index, from 0
+*
+* Return:
+*   Pointer to the histogram, or NULL past the last one in use
+*
+**************************************************************************************************/
+const app_latency_hist_t *app_latency_get(uint8_t index);
+
+/**************************************************************************************************
+* Function Name: app_latency_dump()
+***************************************************************************************************
+* Summary:
+*   This function traces every histogram in use
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_latency_dump(void);
+
+#else
+
+#define APP_LATENCY_BEGIN()
+#define APP_LATENCY_END(site, code)
+#define app_latency_init()
+#define app_latency_dump()
+
+#endif /* APP_LATENCY_STATS */
+
+#endif /* APP_LATENCY_H_ */
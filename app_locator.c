@@ -0,0 +1,1056 @@
+/*******************************************************************************
+* File Name: app_locator.c
+*
+* Description: Source file for the Find Me Locator role, a GATT client that alerts bonded
+*              peers through their Immediate Alert service
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifdef APP_LOCATOR
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_bt_uuid.h"
+#include "wiced_timer.h"
+#include "wiced_hal_nvram.h"
+#include "app_bt_cfg.h"
+#include "app_bt_conn.h"
+#include "app_locator.h"
+#include "app_time.h"
+#include "app_log.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* HCI role of the local device on a link it initiated */
+#define APP_LOCATOR_ROLE_CENTRAL        (0u)
+
+/* No peer */
+#define APP_LOCATOR_NONE                (APP_BT_BOND_MAX)
+
+/* sc_handle of a peer without a Service Changed characteristic to subscribe to */
+#define APP_LOCATOR_SC_NONE             (0xFFFFu)
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Progress of the locator on one bonded peer */
+typedef enum
+{
+    APP_LOCATOR_IDLE,               /* Not taken up */
+    APP_LOCATOR_QUEUED,             /* Waiting for a free client link */
+    APP_LOCATOR_CONNECTING,         /* Connection requested */
+    APP_LOCATOR_DISC_SERVICE,       /* Looking for the Immediate Alert service */
+    APP_LOCATOR_DISC_CHAR,          /* Looking for its Alert Level characteristic */
+    APP_LOCATOR_WRITING,            /* Alert level sent, waiting for completion */
+    APP_LOCATOR_DISC_GATT,          /* Looking for the Generic Attribute service */
+    APP_LOCATOR_DISC_SC,            /* Looking for its Service Changed characteristic */
+    APP_LOCATOR_DISC_SC_CCCD,       /* Looking for the Service Changed configuration descriptor */
+    APP_LOCATOR_SUBSCRIBING,        /* Service Changed indications being enabled */
+    APP_LOCATOR_ALERTED,            /* Alert level set; the link is held until the alert stops */
+    APP_LOCATOR_CLOSING,            /* Own link being disconnected */
+} app_locator_state_t;
+
+/* Locator state of one bonded peer, indexed by bond slot */
+typedef struct
+{
+    uint8_t                   state;        /* app_locator_state_t */
+    uint8_t                   level;        /* Alert level last sent */
+    wiced_bool_t              own_link;     /* Link opened by the locator */
+    wiced_bool_t              cache_hit;    /* alert_handle came from the cache */
+    uint16_t                  conn_id;
+    uint16_t                  s_handle;     /* Handle range of the service being discovered */
+    uint16_t                  e_handle;
+    uint16_t                  alert_handle; /* Alert Level value handle, 0 if unknown */
+    uint16_t                  sc_handle;    /* Service Changed value handle, 0 if not subscribed yet */
+    uint16_t                  cccd_handle;  /* Its configuration descriptor, while subscribing */
+    uint32_t                  start_ms;     /* When the locator took the peer up */
+    wiced_bt_device_address_t bd_addr;      /* Bonded address, as the stack reports the peer */
+    wiced_bt_device_address_t conn_addr;    /* Identity address the connection is requested to */
+} app_locator_peer_t;
+
+/* Discovery cache record, stored in NVRAM at APP_LOCATOR_VSID(bond slot) */
+typedef struct
+{
+    wiced_bt_device_address_t bd_addr;
+    uint16_t                  alert_handle; /* 0 if the record is empty */
+    uint16_t                  sc_handle;    /* Service Changed value handle the peer indicates on */
+} app_locator_cache_t;
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static app_locator_peer_t  app_locator_peer[APP_BT_BOND_MAX];
+static app_locator_cache_t app_locator_cache[APP_BT_BOND_MAX];
+
+/* WICED_TRUE between the button press that starts the alert and the one that stops it */
+static wiced_bool_t        app_locator_active = WICED_FALSE;
+
+/* The stack makes one connection at a time; peers queue for it */
+static uint8_t             app_locator_connecting = APP_LOCATOR_NONE;
+static uint8_t             app_locator_own_links = 0;
+static wiced_timer_t       app_locator_connect_timer;
+
+static app_locator_stats_t app_locator_stats;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+static void app_locator_update(uint8_t slot);
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_locator_find_conn()
+***************************************************************************************************
+* Summary:
+*   This function returns the peer the locator is working on over a connection
+*
+* Parameters:
+*   uint16_t conn_id                    : Connection ID
+*
+* Return:
+*   Bond slot of the peer, or APP_LOCATOR_NONE
+*
+**************************************************************************************************/
+static uint8_t app_locator_find_conn(uint16_t conn_id)
+{
+    for (uint8_t slot = 0; slot < APP_BT_BOND_MAX; slot++)
+    {
+        if ((app_locator_peer[slot].state != APP_LOCATOR_IDLE) && (app_locator_peer[slot].conn_id == conn_id))
+        {
+            return slot;
+        }
+    }
+    return APP_LOCATOR_NONE;
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_cache_save()
+***************************************************************************************************
+* Summary:
+*   This function stores the discovered Alert Level and Service Changed handles of a peer in the
+*   cache and in NVRAM
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_cache_save(uint8_t slot)
+{
+    app_locator_cache_t *p_cache = &app_locator_cache[slot];
+    wiced_result_t result = WICED_BT_ERROR;
+
+    /* Skip the NVRAM write when nothing changed */
+    if ((p_cache->alert_handle == app_locator_peer[slot].alert_handle) &&
+        (p_cache->sc_handle == app_locator_peer[slot].sc_handle) &&
+        (memcmp(p_cache->bd_addr, app_locator_peer[slot].bd_addr, BD_ADDR_LEN) == 0))
+    {
+        return;
+    }
+
+    memcpy(p_cache->bd_addr, app_locator_peer[slot].bd_addr, BD_ADDR_LEN);
+    p_cache->alert_handle = app_locator_peer[slot].alert_handle;
+    p_cache->sc_handle = app_locator_peer[slot].sc_handle;
+    wiced_hal_write_nvram(APP_LOCATOR_VSID(slot), sizeof(app_locator_cache_t), (uint8_t *)p_cache, &result);
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_cache_drop()
+***************************************************************************************************
+* Summary:
+*   This function empties a discovery cache record
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_cache_drop(uint8_t slot)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+
+    if (app_locator_cache[slot].alert_handle != 0)
+    {
+        app_locator_cache[slot].alert_handle = 0;
+        app_locator_cache[slot].sc_handle = 0;
+        wiced_hal_delete_nvram(APP_LOCATOR_VSID(slot), &result);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_cache_stale()
+***************************************************************************************************
+* Summary:
+*   This function drops the cached handles of a peer whose database changed, so they are
+*   discovered again and the alert level is sent again on the next update
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_cache_stale(uint8_t slot)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+
+    app_locator_stats.cache_stale++;
+    app_locator_cache_drop(slot);
+    p_peer->alert_handle = 0;
+    p_peer->sc_handle = 0;
+    p_peer->cache_hit = WICED_FALSE;
+    p_peer->level = 0;
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_release()
+***************************************************************************************************
+* Summary:
+*   This function ends the work on a peer, disconnecting the link if the locator opened it
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_release(uint8_t slot)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+
+    if (p_peer->own_link)
+    {
+        /* The entry is freed by the disconnection */
+        p_peer->state = APP_LOCATOR_CLOSING;
+        wiced_bt_gatt_disconnect(p_peer->conn_id);
+    }
+    else
+    {
+        memset(p_peer, 0, sizeof(app_locator_peer_t));
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_discover()
+***************************************************************************************************
+* Summary:
+*   This function starts a discovery step on a peer: the Immediate Alert service, then its
+*   characteristics; or the Generic Attribute service, its Service Changed characteristic and
+*   that characteristic's configuration descriptor
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*   app_locator_state_t state           : APP_LOCATOR_DISC_SERVICE to APP_LOCATOR_DISC_SC_CCCD
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_discover(uint8_t slot, app_locator_state_t state)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+    wiced_bt_gatt_discovery_type_t type = GATT_DISCOVER_CHARACTERISTICS;
+    wiced_bt_gatt_discovery_param_t param;
+
+    memset(&param, 0, sizeof(param));
+    if ((state == APP_LOCATOR_DISC_SERVICE) || (state == APP_LOCATOR_DISC_GATT))
+    {
+        type = GATT_DISCOVER_SERVICES_BY_UUID;
+        param.uuid.len = LEN_UUID_16;
+        param.uuid.uu.uuid16 = (state == APP_LOCATOR_DISC_SERVICE) ? UUID_SERVICE_IMMEDIATE_ALERT : UUID_SERVICE_GATT;
+        param.s_handle = 0x0001;
+        param.e_handle = 0xFFFF;
+        p_peer->s_handle = 0;
+        p_peer->e_handle = 0;
+    }
+    else if (state == APP_LOCATOR_DISC_SC_CCCD)
+    {
+        /* The descriptors follow the value, up to the end of the service */
+        type = GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS;
+        param.s_handle = p_peer->sc_handle + 1u;
+        param.e_handle = p_peer->e_handle;
+        p_peer->cccd_handle = 0;
+    }
+    else
+    {
+        param.s_handle = p_peer->s_handle;
+        param.e_handle = p_peer->e_handle;
+    }
+    p_peer->state = state;
+
+    if (wiced_bt_gatt_send_discover(p_peer->conn_id, type, &param) != WICED_BT_GATT_SUCCESS)
+    {
+        app_locator_release(slot);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_write()
+***************************************************************************************************
+* Summary:
+*   This function sends an alert level to a peer whose Alert Level handle is known
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*   uint8_t level                       : Alert level
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_write(uint8_t slot, uint8_t level)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+    wiced_bt_gatt_value_t value;
+
+    memset(&value, 0, sizeof(value));
+    value.handle = p_peer->alert_handle;
+    value.len = 1;
+    value.auth_req = GATT_AUTH_REQ_NONE;
+    value.value[0] = level;
+
+    p_peer->level = level;
+    p_peer->state = APP_LOCATOR_WRITING;
+
+    /* Alert Level only takes Write Without Response: a single PDU, and the
+     * stack reports completion as soon as it is sent. The peer never answers,
+     * so a cached handle is trusted until a Service Changed indication or a
+     * failed write says otherwise */
+    if (wiced_bt_gatt_send_write(p_peer->conn_id, GATT_WRITE_NO_RSP, &value) != WICED_BT_GATT_SUCCESS)
+    {
+        app_locator_release(slot);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_subscribe()
+***************************************************************************************************
+* Summary:
+*   This function enables Service Changed indications on a peer, so a change of its database
+*   drops the cached handles instead of every alert having to check them
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_subscribe(uint8_t slot)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+    wiced_bt_gatt_value_t value;
+
+    memset(&value, 0, sizeof(value));
+    value.handle = p_peer->cccd_handle;
+    value.len = 2;
+    value.auth_req = GATT_AUTH_REQ_NONE;
+    value.value[0] = GATT_CLIENT_CONFIG_INDICATION;
+
+    p_peer->state = APP_LOCATOR_SUBSCRIBING;
+
+    if (wiced_bt_gatt_send_write(p_peer->conn_id, GATT_WRITE, &value) != WICED_BT_GATT_SUCCESS)
+    {
+        app_locator_release(slot);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_update()
+***************************************************************************************************
+* Summary:
+*   This function brings a peer with a link and no operation pending in line with the locator:
+*   it sends the alert level if it differs, discovering the handle first if needed, subscribes to
+*   Service Changed once the alert is out, and releases the peer once the alert is stopped
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_update(uint8_t slot)
+{
+    app_locator_peer_t *p_peer = &app_locator_peer[slot];
+    uint8_t level = app_locator_active ? APP_LOCATOR_ALERT_LEVEL : 0;
+
+    if (p_peer->alert_handle == 0)
+    {
+        if (!app_locator_active)
+        {
+            app_locator_release(slot);
+        }
+        else
+        {
+            app_locator_discover(slot, APP_LOCATOR_DISC_SERVICE);
+        }
+    }
+    else if (p_peer->level != level)
+    {
+        app_locator_write(slot, level);
+    }
+    else if (app_locator_active && (p_peer->sc_handle == 0))
+    {
+        /* After the alert, so it does not wait for the extra round trips */
+        app_locator_discover(slot, APP_LOCATOR_DISC_GATT);
+    }
+    else if (app_locator_active)
+    {
+        p_peer->state = APP_LOCATOR_ALERTED;
+    }
+    else
+    {
+        app_locator_release(slot);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_connect_next()
+***************************************************************************************************
+* Summary:
+*   This function connects to the next queued peer, if no connection is being made and a client
+*   link is free
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_connect_next(void)
+{
+    app_locator_peer_t *p_peer = NULL;
+    const wiced_bt_device_link_keys_t *p_keys = NULL;
+    wiced_bt_ble_address_type_t addr_type = BLE_ADDR_PUBLIC;
+
+    if ((app_locator_connecting != APP_LOCATOR_NONE) || (app_locator_own_links >= APP_BT_MAX_CLIENT_CONN))
+    {
+        return;
+    }
+
+    for (uint8_t slot = 0; slot < APP_BT_BOND_MAX; slot++)
+    {
+        p_peer = &app_locator_peer[slot];
+        if (p_peer->state != APP_LOCATOR_QUEUED)
+        {
+            continue;
+        }
+
+        p_keys = app_bt_bond_get(slot);
+        if (p_keys != NULL)
+        {
+            app_bt_bond_identity(p_keys, p_peer->conn_addr, &addr_type);
+        }
+
+        if ((p_keys != NULL) &&
+            wiced_bt_gatt_le_connect(p_peer->conn_addr, addr_type, BLE_CONN_MODE_HIGH_DUTY, WICED_TRUE))
+        {
+            p_peer->state = APP_LOCATOR_CONNECTING;
+            p_peer->start_ms = app_time_ms();
+            app_locator_connecting = slot;
+            wiced_start_timer(&app_locator_connect_timer, APP_LOCATOR_CONNECT_TIMEOUT_MS);
+            return;
+        }
+
+        app_locator_stats.connect_failures++;
+        memset(p_peer, 0, sizeof(app_locator_peer_t));
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_connect_timeout()
+***************************************************************************************************
+* Summary:
+*   This function gives up on a peer that could not be connected in time and moves on to the
+*   next one
+*
+* Parameters:
+*   uint32_t arg                        : Unused
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_connect_timeout(uint32_t arg)
+{
+    app_locator_peer_t *p_peer = NULL;
+
+    if (app_locator_connecting == APP_LOCATOR_NONE)
+    {
+        return;
+    }
+
+    p_peer = &app_locator_peer[app_locator_connecting];
+    APP_LOG_BDA1(APP_LOG_ID_LOCATOR_UNREACHABLE, p_peer->bd_addr, APP_LOCATOR_CONNECT_TIMEOUT_MS);
+
+    wiced_bt_gatt_cancel_connect(p_peer->conn_addr, WICED_TRUE);
+    app_locator_stats.connect_failures++;
+    memset(p_peer, 0, sizeof(app_locator_peer_t));
+    app_locator_connecting = APP_LOCATOR_NONE;
+
+    app_locator_connect_next();
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_init()
+***************************************************************************************************
+* Summary:
+*   This function loads the discovery cache from NVRAM. It is called after the bond table is
+*   loaded
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_init(void)
+{
+    wiced_result_t result = WICED_BT_ERROR;
+
+    for (uint8_t slot = 0; slot < APP_BT_BOND_MAX; slot++)
+    {
+        /* A value handle follows its declaration, so it is at least 2 */
+        if ((wiced_hal_read_nvram(APP_LOCATOR_VSID(slot), sizeof(app_locator_cache_t),
+                (uint8_t *)&app_locator_cache[slot], &result) != sizeof(app_locator_cache_t)) ||
+            (result != WICED_BT_SUCCESS) || (app_locator_cache[slot].alert_handle < 2u))
+        {
+            memset(&app_locator_cache[slot], 0, sizeof(app_locator_cache_t));
+        }
+    }
+
+    wiced_init_timer(&app_locator_connect_timer, app_locator_connect_timeout, 0, WICED_MILLI_SECONDS_TIMER);
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_toggle()
+***************************************************************************************************
+* Summary:
+*   This function starts alerting every bonded peer, or stops the alert if it is running. It is
+*   called on a button press
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_toggle(void)
+{
+    app_locator_peer_t *p_peer = NULL;
+    const wiced_bt_device_link_keys_t *p_keys = NULL;
+    app_bt_conn_t *p_conn = NULL;
+
+    app_locator_active = !app_locator_active;
+    APP_LOG1(APP_LOG_ID_LOCATOR, app_locator_active ? APP_LOCATOR_ALERT_LEVEL : 0);
+
+    for (uint8_t slot = 0; slot < APP_BT_BOND_MAX; slot++)
+    {
+        p_peer = &app_locator_peer[slot];
+
+        switch (p_peer->state)
+        {
+            case APP_LOCATOR_IDLE:
+                p_keys = app_bt_bond_get(slot);
+                if (!app_locator_active || (p_keys == NULL))
+                {
+                    break;
+                }
+
+                /* Take the peer up; the handles come from the cache if they
+                 * were discovered before */
+                memcpy(p_peer->bd_addr, p_keys->bd_addr, BD_ADDR_LEN);
+                p_peer->start_ms = app_time_ms();
+                if (memcmp(app_locator_cache[slot].bd_addr, p_keys->bd_addr, BD_ADDR_LEN) == 0)
+                {
+                    p_peer->alert_handle = app_locator_cache[slot].alert_handle;
+                    p_peer->sc_handle = app_locator_cache[slot].sc_handle;
+                    p_peer->cache_hit = (p_peer->alert_handle != 0) ? WICED_TRUE : WICED_FALSE;
+                }
+
+                /* A peer connected to the tag is reached over its link */
+                p_conn = app_bt_conn_get_by_bd_addr(p_peer->bd_addr);
+                if (p_conn != NULL)
+                {
+                    p_peer->conn_id = p_conn->conn_id;
+                    app_locator_update(slot);
+                }
+                else
+                {
+                    p_peer->state = APP_LOCATOR_QUEUED;
+                }
+                break;
+
+            case APP_LOCATOR_QUEUED:
+                memset(p_peer, 0, sizeof(app_locator_peer_t));
+                break;
+
+            case APP_LOCATOR_CONNECTING:
+                wiced_stop_timer(&app_locator_connect_timer);
+                wiced_bt_gatt_cancel_connect(p_peer->conn_addr, WICED_TRUE);
+                memset(p_peer, 0, sizeof(app_locator_peer_t));
+                app_locator_connecting = APP_LOCATOR_NONE;
+                break;
+
+            case APP_LOCATOR_ALERTED:
+                app_locator_update(slot);
+                break;
+
+            default:
+                /* Discovery or a write is in flight; its completion catches up */
+                break;
+        }
+    }
+
+    app_locator_connect_next();
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_forget()
+***************************************************************************************************
+* Summary:
+*   This function drops the cached handles of a peer, so they are discovered again. It is
+*   called when the peer pairs again, as it may have been reset
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_forget(wiced_bt_device_address_t bd_addr)
+{
+    for (uint8_t slot = 0; slot < APP_BT_BOND_MAX; slot++)
+    {
+        if (memcmp(app_locator_cache[slot].bd_addr, bd_addr, BD_ADDR_LEN) == 0)
+        {
+            app_locator_cache_drop(slot);
+        }
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_on_connection_status()
+***************************************************************************************************
+* Summary:
+*   This function handles connection status changes. Links opened by the locator are kept out
+*   of the client table and handled here entirely
+*
+* Parameters:
+*   wiced_bt_gatt_connection_status_t *p_conn_status  : Connection details
+*
+* Return:
+*   WICED_TRUE if the link was opened by the locator, WICED_FALSE if it is a client link
+*
+**************************************************************************************************/
+wiced_bool_t app_locator_on_connection_status(wiced_bt_gatt_connection_status_t *p_conn_status)
+{
+    uint8_t slot = APP_LOCATOR_NONE;
+    wiced_bool_t own_link = WICED_FALSE;
+
+    if (p_conn_status->connected)
+    {
+        if (p_conn_status->link_role != APP_LOCATOR_ROLE_CENTRAL)
+        {
+            return WICED_FALSE;
+        }
+
+        /* A connection that completed just after it was cancelled */
+        if (app_locator_connecting == APP_LOCATOR_NONE)
+        {
+            wiced_bt_gatt_disconnect(p_conn_status->conn_id);
+            return WICED_TRUE;
+        }
+
+        slot = app_locator_connecting;
+        app_locator_connecting = APP_LOCATOR_NONE;
+        wiced_stop_timer(&app_locator_connect_timer);
+
+        app_locator_peer[slot].conn_id = p_conn_status->conn_id;
+        app_locator_peer[slot].own_link = WICED_TRUE;
+        app_locator_own_links++;
+
+        app_locator_update(slot);
+        app_locator_connect_next();
+        return WICED_TRUE;
+    }
+
+    slot = app_locator_find_conn(p_conn_status->conn_id);
+    if (slot == APP_LOCATOR_NONE)
+    {
+        /* A late connection disconnected above, or a link the locator never used */
+        return (p_conn_status->link_role == APP_LOCATOR_ROLE_CENTRAL) ? WICED_TRUE : WICED_FALSE;
+    }
+
+    own_link = app_locator_peer[slot].own_link;
+    memset(&app_locator_peer[slot], 0, sizeof(app_locator_peer_t));
+    if (own_link)
+    {
+        app_locator_own_links--;
+        app_locator_connect_next();
+    }
+    return own_link;
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_on_discovery_result()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_DISCOVERY_RESULT_EVT
+*
+* Parameters:
+*   wiced_bt_gatt_discovery_result_t *p_result : Discovered service or characteristic
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_discovery_result(wiced_bt_gatt_discovery_result_t *p_result)
+{
+    uint8_t slot = app_locator_find_conn(p_result->conn_id);
+    app_locator_peer_t *p_peer = NULL;
+    wiced_bt_gatt_char_declaration_t *p_char = NULL;
+    wiced_bt_gatt_char_descr_info_t *p_descr = NULL;
+
+    if (slot == APP_LOCATOR_NONE)
+    {
+        return;
+    }
+    p_peer = &app_locator_peer[slot];
+
+    if (((p_peer->state == APP_LOCATOR_DISC_SERVICE) || (p_peer->state == APP_LOCATOR_DISC_GATT)) &&
+        (p_result->discovery_type == GATT_DISCOVER_SERVICES_BY_UUID))
+    {
+        p_peer->s_handle = p_result->discovery_data.group_value.s_handle;
+        p_peer->e_handle = p_result->discovery_data.group_value.e_handle;
+    }
+    else if ((p_peer->state == APP_LOCATOR_DISC_CHAR) && (p_result->discovery_type == GATT_DISCOVER_CHARACTERISTICS))
+    {
+        p_char = &p_result->discovery_data.characteristic_declaration;
+        if ((p_char->char_uuid.len == LEN_UUID_16) && (p_char->char_uuid.uu.uuid16 == UUID_CHARACTERISTIC_ALERT_LEVEL))
+        {
+            p_peer->alert_handle = p_char->val_handle;
+        }
+    }
+    else if ((p_peer->state == APP_LOCATOR_DISC_SC) && (p_result->discovery_type == GATT_DISCOVER_CHARACTERISTICS))
+    {
+        p_char = &p_result->discovery_data.characteristic_declaration;
+        if ((p_char->char_uuid.len == LEN_UUID_16) && (p_char->char_uuid.uu.uuid16 == UUID_CHARACTERISTIC_SERVICE_CHANGED))
+        {
+            p_peer->sc_handle = p_char->val_handle;
+        }
+    }
+    else if ((p_peer->state == APP_LOCATOR_DISC_SC_CCCD) && (p_result->discovery_type == GATT_DISCOVER_CHARACTERISTIC_DESCRIPTORS))
+    {
+        p_descr = &p_result->discovery_data.char_descr_info;
+        if ((p_descr->type.len == LEN_UUID_16) && (p_descr->type.uu.uuid16 == UUID_DESCRIPTOR_CLIENT_CHARACTERISTIC_CONFIGURATION) &&
+            (p_peer->cccd_handle == 0))
+        {
+            p_peer->cccd_handle = p_descr->handle;
+        }
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_on_discovery_complete()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_DISCOVERY_CPLT_EVT and moves on to the next discovery step
+*
+* Parameters:
+*   wiced_bt_gatt_discovery_complete_t *p_complete : Completed discovery
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_discovery_complete(wiced_bt_gatt_discovery_complete_t *p_complete)
+{
+    uint8_t slot = app_locator_find_conn(p_complete->conn_id);
+    app_locator_peer_t *p_peer = NULL;
+
+    if (slot == APP_LOCATOR_NONE)
+    {
+        return;
+    }
+    p_peer = &app_locator_peer[slot];
+
+    if (p_peer->state == APP_LOCATOR_DISC_SERVICE)
+    {
+        if ((p_peer->s_handle != 0) && app_locator_active)
+        {
+            app_locator_discover(slot, APP_LOCATOR_DISC_CHAR);
+            return;
+        }
+    }
+    else if (p_peer->state == APP_LOCATOR_DISC_CHAR)
+    {
+        if (p_peer->alert_handle != 0)
+        {
+            /* Reconnections write to this handle without discovering it */
+            p_peer->sc_handle = 0;
+            app_locator_cache_save(slot);
+            app_locator_update(slot);
+            return;
+        }
+    }
+    else if ((p_peer->state == APP_LOCATOR_DISC_GATT) || (p_peer->state == APP_LOCATOR_DISC_SC) ||
+             (p_peer->state == APP_LOCATOR_DISC_SC_CCCD))
+    {
+        if ((p_peer->state == APP_LOCATOR_DISC_GATT) && (p_peer->s_handle != 0))
+        {
+            p_peer->sc_handle = 0;
+            app_locator_discover(slot, APP_LOCATOR_DISC_SC);
+        }
+        else if ((p_peer->state == APP_LOCATOR_DISC_SC) && (p_peer->sc_handle != 0))
+        {
+            app_locator_discover(slot, APP_LOCATOR_DISC_SC_CCCD);
+        }
+        else if ((p_peer->state == APP_LOCATOR_DISC_SC_CCCD) && (p_peer->cccd_handle != 0))
+        {
+            app_locator_subscribe(slot);
+        }
+        else
+        {
+            /* Without Service Changed the cached handle is kept until a write fails */
+            p_peer->sc_handle = APP_LOCATOR_SC_NONE;
+            app_locator_cache_save(slot);
+            app_locator_update(slot);
+        }
+        return;
+    }
+    else
+    {
+        return;
+    }
+
+    if (app_locator_active)
+    {
+        app_locator_stats.not_found++;
+        APP_LOG1(APP_LOG_ID_LOCATOR_NO_IAS, p_complete->conn_id);
+    }
+    app_locator_release(slot);
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_on_indication()
+***************************************************************************************************
+* Summary:
+*   This function confirms an indication and, if it is the Service Changed indication of a
+*   peer, drops the peer's cached handles. A peer the locator is working on is brought up to
+*   date at once; for an idle one only the cache is dropped
+*
+* Parameters:
+*   uint8_t slot                        : Bond slot of the peer, or APP_LOCATOR_NONE
+*   uint16_t conn_id                    : Connection ID the indication arrived on
+*   uint16_t handle                     : Attribute handle of the indication
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_locator_on_indication(uint8_t slot, uint16_t conn_id, uint16_t handle)
+{
+    app_locator_peer_t *p_peer = NULL;
+    app_bt_conn_t *p_conn = NULL;
+
+    /* Left unconfirmed, an indication blocks the next ones until the ATT timeout */
+    wiced_bt_gatt_send_indication_confirm(conn_id, handle);
+
+    if (slot != APP_LOCATOR_NONE)
+    {
+        p_peer = &app_locator_peer[slot];
+        if ((p_peer->alert_handle != 0) && (handle == p_peer->sc_handle))
+        {
+            app_locator_cache_stale(slot);
+
+            /* In any other state, the completion of the pending operation
+             * calls app_locator_update() */
+            if (p_peer->state == APP_LOCATOR_ALERTED)
+            {
+                app_locator_update(slot);
+            }
+        }
+        return;
+    }
+
+    /* A subscribed peer that connects on its own reports the change while
+     * the locator is idle */
+    p_conn = app_bt_conn_get(conn_id);
+    if (p_conn == NULL)
+    {
+        return;
+    }
+
+    for (uint8_t i = 0; i < APP_BT_BOND_MAX; i++)
+    {
+        if ((app_locator_cache[i].alert_handle != 0) && (app_locator_cache[i].sc_handle == handle) &&
+            (memcmp(app_locator_cache[i].bd_addr, p_conn->bd_addr, BD_ADDR_LEN) == 0))
+        {
+            app_locator_stats.cache_stale++;
+            app_locator_cache_drop(i);
+        }
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_on_operation_complete()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_OPERATION_CPLT_EVT: the alert level and subscription writes, and
+*   Service Changed indications, which drop the cached handles of the peer that sent them
+*
+* Parameters:
+*   wiced_bt_gatt_operation_complete_t *p_complete : Completed operation
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_operation_complete(wiced_bt_gatt_operation_complete_t *p_complete)
+{
+    uint8_t slot = app_locator_find_conn(p_complete->conn_id);
+    app_locator_peer_t *p_peer = NULL;
+    uint32_t elapsed_ms = 0;
+
+    if (p_complete->op == GATTC_OPTYPE_INDICATION)
+    {
+        app_locator_on_indication(slot, p_complete->conn_id, p_complete->response_data.att_value.handle);
+        return;
+    }
+
+    if ((slot == APP_LOCATOR_NONE) || (p_complete->op != GATTC_OPTYPE_WRITE))
+    {
+        return;
+    }
+    p_peer = &app_locator_peer[slot];
+
+    if (p_peer->state == APP_LOCATOR_SUBSCRIBING)
+    {
+        /* A peer that refuses is not asked again; its handle is kept until a write fails */
+        if (p_complete->status != WICED_BT_GATT_SUCCESS)
+        {
+            p_peer->sc_handle = APP_LOCATOR_SC_NONE;
+        }
+        app_locator_cache_save(slot);
+        app_locator_update(slot);
+        return;
+    }
+
+    if (p_peer->state != APP_LOCATOR_WRITING)
+    {
+        return;
+    }
+
+    /* The peer never answers this write, but an invalid handle reported for
+     * a cached one still means the cache is stale: discover it again */
+    if ((p_complete->status == WICED_BT_GATT_INVALID_HANDLE) && p_peer->cache_hit)
+    {
+        app_locator_cache_stale(slot);
+        app_locator_update(slot);
+        return;
+    }
+
+    if (p_complete->status != WICED_BT_GATT_SUCCESS)
+    {
+        app_locator_release(slot);
+        return;
+    }
+
+    /* Time to alert, counted once per take-up */
+    if ((p_peer->level != 0) && (p_peer->start_ms != 0))
+    {
+        elapsed_ms = app_time_ms() - p_peer->start_ms;
+        p_peer->start_ms = 0;
+
+        app_locator_stats.alerts++;
+        if (p_peer->cache_hit)
+        {
+            app_locator_stats.cache_hits++;
+            app_locator_stats.last_hit_ms = elapsed_ms;
+            app_locator_stats.total_hit_ms += elapsed_ms;
+        }
+        else
+        {
+            app_locator_stats.cache_misses++;
+            app_locator_stats.last_miss_ms = elapsed_ms;
+            app_locator_stats.total_miss_ms += elapsed_ms;
+        }
+        APP_LOG_BDA2(APP_LOG_ID_LOCATOR_ALERTED, p_peer->bd_addr, elapsed_ms, p_peer->cache_hit);
+    }
+
+    /* The alert may have been stopped or restarted meanwhile */
+    app_locator_update(slot);
+}
+
+/**************************************************************************************************
+* Function Name: app_locator_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the locator statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_locator_stats_t *app_locator_get_stats(void)
+{
+    return &app_locator_stats;
+}
+
+#endif /* APP_LOCATOR */
+
+/* [] END OF FILE */
@@ -0,0 +1,231 @@
+/*******************************************************************************
+* File Name: app_locator.h
+*
+* Description: Header file for the Find Me Locator role, a GATT client that alerts bonded
+*              peers through their Immediate Alert service
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_LOCATOR_H_
+#define APP_LOCATOR_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_dev.h"
+#include "wiced_bt_gatt.h"
+#include "app_bt_bond.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* Alert level written to the peers when the locator is triggered */
+#ifndef APP_LOCATOR_ALERT_LEVEL
+#define APP_LOCATOR_ALERT_LEVEL         (2u)
+#endif
+
+/* Time allowed to connect to a peer that is not connected already */
+#ifndef APP_LOCATOR_CONNECT_TIMEOUT_MS
+#define APP_LOCATOR_CONNECT_TIMEOUT_MS  (10u * 1000u)
+#endif
+
+/* NVRAM layout of the discovery cache: one record per bond slot, after the
+ * bond table */
+#define APP_LOCATOR_VSID(i)             (APP_BT_BOND_VSID_END + (i))
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Locator statistics. Time to alert runs from the locator taking up a peer,
+ * over an existing link or by connecting to it, to the alert level being sent */
+typedef struct
+{
+    uint32_t alerts;                /* Alert level writes sent */
+    uint32_t connect_failures;      /* Peers that could not be reached */
+    uint32_t not_found;             /* Peers without an Immediate Alert service */
+    uint32_t cache_hits;            /* Alerts sent with the handle from the cache */
+    uint32_t last_hit_ms;           /* Time to alert of the last cache hit */
+    uint32_t total_hit_ms;          /* Sum of all cache hit times to alert, for the average */
+    uint32_t cache_misses;          /* Alerts sent after discovering the service */
+    uint32_t last_miss_ms;          /* Time to alert of the last cache miss */
+    uint32_t total_miss_ms;         /* Sum of all cache miss times to alert, for the average */
+    uint32_t cache_stale;           /* Cached handles dropped on Service Changed or an invalid handle */
+} app_locator_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#ifdef APP_LOCATOR
+
+/**************************************************************************************************
+* Function Name: app_locator_init()
+***************************************************************************************************
+* Summary:
+*   This function loads the discovery cache from NVRAM. It is called after the bond table is
+*   loaded
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_init(void);
+
+/**************************************************************************************************
+* Function Name: app_locator_toggle()
+***************************************************************************************************
+* Summary:
+*   This function starts alerting every bonded peer, or stops the alert if it is running. It is
+*   called on a button press
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_toggle(void);
+
+/**************************************************************************************************
+* Function Name: app_locator_forget()
+***************************************************************************************************
+* Summary:
+*   This function drops the cached handles of a peer, so they are discovered again. It is
+*   called when the peer pairs again, as it may have been reset
+*
+* Parameters:
+*   wiced_bt_device_address_t bd_addr   : Peer device address
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_forget(wiced_bt_device_address_t bd_addr);
+
+/**************************************************************************************************
+* Function Name: app_locator_on_connection_status()
+***************************************************************************************************
+* Summary:
+*   This function handles connection status changes. Links opened by the locator are kept out
+*   of the client table and handled here entirely
+*
+* Parameters:
+*   wiced_bt_gatt_connection_status_t *p_conn_status  : Connection details
+*
+* Return:
+*   WICED_TRUE if the link was opened by the locator, WICED_FALSE if it is a client link
+*
+**************************************************************************************************/
+wiced_bool_t app_locator_on_connection_status(wiced_bt_gatt_connection_status_t *p_conn_status);
+
+/**************************************************************************************************
+* Function Name: app_locator_on_discovery_result()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_DISCOVERY_RESULT_EVT
+*
+* Parameters:
+*   wiced_bt_gatt_discovery_result_t *p_result : Discovered service or characteristic
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_discovery_result(wiced_bt_gatt_discovery_result_t *p_result);
+
+/**************************************************************************************************
+* Function Name: app_locator_on_discovery_complete()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_DISCOVERY_CPLT_EVT and moves on to the next discovery step
+*
+* Parameters:
+*   wiced_bt_gatt_discovery_complete_t *p_complete : Completed discovery
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_discovery_complete(wiced_bt_gatt_discovery_complete_t *p_complete);
+
+/**************************************************************************************************
+* Function Name: app_locator_on_operation_complete()
+***************************************************************************************************
+* Summary:
+*   This function handles GATT_OPERATION_CPLT_EVT for the alert level writes
+*
+* Parameters:
+*   wiced_bt_gatt_operation_complete_t *p_complete : Completed operation
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_locator_on_operation_complete(wiced_bt_gatt_operation_complete_t *p_complete);
+
+/**************************************************************************************************
+* Function Name: app_locator_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the locator statistics
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_locator_stats_t *app_locator_get_stats(void);
+
+#else
+
+#define app_locator_init()
+#define app_locator_toggle()
+#define app_locator_forget(bd_addr)
+#define app_locator_on_connection_status(p_conn_status)     (WICED_FALSE)
+#define app_locator_on_discovery_result(p_result)
+#define app_locator_on_discovery_complete(p_complete)
+#define app_locator_on_operation_complete(p_complete)
+
+#endif /* APP_LOCATOR */
+
+#endif /* APP_LOCATOR_H_ */
+
+/* [] END OF FILE */
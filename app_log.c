@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name: app_log.c
+*
+* Description: Source file for application logging: the message format table, or with
+*              BINARY_LOG=1 the RAM ring of binary records and its background flush
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "app_log.h"
+
+#ifdef APP_BINARY_LOG
+#include "wiced_hal_puart.h"
+#include "app_event_queue.h"
+#include "app_time.h"
+#endif
+
+#ifndef APP_BINARY_LOG
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+#define APP_LOG_ID_FMT(id, fmt)         [id] = fmt,
+
+const char * const app_log_fmt[APP_LOG_ID_COUNT] =
+{
+    APP_LOG_IDS(APP_LOG_ID_FMT)
+};
+
+#else
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#define APP_LOG_RING_MASK               (APP_LOG_RING_WORDS - 1u)
+
+/* Largest record: header and timestamp words plus arguments */
+#define APP_LOG_MAX_ARGS                (6u)
+#define APP_LOG_MAX_WORDS               (2u + APP_LOG_MAX_ARGS)
+
+_Static_assert((APP_LOG_RING_WORDS & APP_LOG_RING_MASK) == 0, "APP_LOG_RING_WORDS must be a power of two");
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+/* Record layout: header word (ID in bits 0-7, argument count in bits 8-15),
+ * app_time_ms() word, then the arguments. Log sites and the drain all run on
+ * the application thread, so the ring needs no locking */
+static uint32_t app_log_ring[APP_LOG_RING_WORDS];
+static uint16_t app_log_head = 0;
+static uint16_t app_log_tail = 0;
+static uint32_t app_log_dropped = 0;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_log_send_frame()
+***************************************************************************************************
+* Summary:
+*   This function writes one record to the debug UART as a binary frame
+*
+* Parameters:
+*   const uint32_t *p_words             : Record words
+*   uint8_t nwords                      : Number of record words
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_log_send_frame(const uint32_t *p_words, uint8_t nwords)
+{
+    uint8_t frame[2 + 4 * APP_LOG_MAX_WORDS];
+    uint8_t len = 0;
+
+    frame[len++] = APP_LOG_FRAME_SYNC;
+    frame[len++] = nwords;
+    for (uint8_t i = 0; i < nwords; i++)
+    {
+        frame[len++] = (uint8_t)(p_words[i]);
+        frame[len++] = (uint8_t)(p_words[i] >> 8);
+        frame[len++] = (uint8_t)(p_words[i] >> 16);
+        frame[len++] = (uint8_t)(p_words[i] >> 24);
+    }
+
+    wiced_hal_puart_synchronous_write(frame, len);
+}
+
+/**************************************************************************************************
+* Function Name: app_log_write()
+***************************************************************************************************
+* Summary:
+*   This function copies a record into the RAM ring and requests a background flush. Use the
+*   APP_LOG macros rather than calling it directly
+*
+* Parameters:
+*   app_log_id_t id                     : Message ID
+*   uint8_t nargs                       : Number of argument words
+*   const uint32_t *p_args              : Argument words
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_log_write(app_log_id_t id, uint8_t nargs, const uint32_t *p_args)
+{
+    uint16_t used = (uint16_t)(app_log_head - app_log_tail);
+
+    if (nargs > APP_LOG_MAX_ARGS)
+    {
+        nargs = APP_LOG_MAX_ARGS;
+    }
+
+    if (used + 2u + nargs > APP_LOG_RING_WORDS)
+    {
+        app_log_dropped++;
+        return;
+    }
+
+    app_log_ring[app_log_head++ & APP_LOG_RING_MASK] = (uint32_t)id | ((uint32_t)nargs << 8);
+    app_log_ring[app_log_head++ & APP_LOG_RING_MASK] = app_time_ms();
+    for (uint8_t i = 0; i < nargs; i++)
+    {
+        app_log_ring[app_log_head++ & APP_LOG_RING_MASK] = p_args[i];
+    }
+
+    app_event_signal(APP_EVENT_LOG_DRAIN);
+}
+
+/**************************************************************************************************
+* Function Name: app_log_drain()
+***************************************************************************************************
+* Summary:
+*   This function writes the queued records to the debug UART. It runs from the application
+*   event queue, outside the Bluetooth stack callbacks
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_log_drain(void)
+{
+    uint32_t words[APP_LOG_MAX_WORDS];
+    uint8_t nwords = 0;
+
+    while (app_log_tail != app_log_head)
+    {
+        nwords = (uint8_t)(2u + ((app_log_ring[app_log_tail & APP_LOG_RING_MASK] >> 8) & 0xFFu));
+        for (uint8_t i = 0; i < nwords; i++)
+        {
+            words[i] = app_log_ring[app_log_tail++ & APP_LOG_RING_MASK];
+        }
+        app_log_send_frame(words, nwords);
+    }
+
+    /* Report losses after the records that made it, where they happened */
+    if (app_log_dropped != 0)
+    {
+        words[0] = (uint32_t)APP_LOG_ID_DROPPED | (1u << 8);
+        words[1] = app_time_ms();
+        words[2] = app_log_dropped;
+        app_log_dropped = 0;
+        app_log_send_frame(words, 3);
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_log_idle()
+***************************************************************************************************
+* Summary:
+*   This function reports whether every record has been sent on the UART
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if the ring is empty, no loss is left to report and the UART transmit FIFO
+*   has emptied
+*
+**************************************************************************************************/
+wiced_bool_t app_log_idle(void)
+{
+    /* The synchronous write returns once the last bytes are in the FIFO, not on the wire */
+    return ((app_log_tail == app_log_head) && (app_log_dropped == 0) && wiced_hal_puart_is_tx_fifo_empty()) ?
+            WICED_TRUE : WICED_FALSE;
+}
+
+#endif /* APP_BINARY_LOG */
+
+/* [] END OF FILE */
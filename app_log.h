@@ -0,0 +1,173 @@
+/*******************************************************************************
+* File Name: app_log.h
+*
+* Description: Header file for application logging. Log sites name a message by ID; with
+*              BINARY_LOG=1 the ID and raw arguments go to a RAM ring that is flushed to the
+*              debug UART in the background, otherwise they are formatted by WICED_BT_TRACE
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_LOG_H_
+#define APP_LOG_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced.h"
+#include "wiced_bt_trace.h"
+#include "wiced_hal_puart.h"
+#include "app_log_ids.h"
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+#define APP_LOG_ID_ENUM(id, fmt)        id,
+
+typedef enum
+{
+    APP_LOG_IDS(APP_LOG_ID_ENUM)
+    APP_LOG_ID_COUNT
+} app_log_id_t;
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+#ifdef APP_BINARY_LOG
+
+/* RAM ring capacity in 32-bit words. A record takes two words plus one per
+ * argument, and two per device address */
+#ifndef APP_LOG_RING_WORDS
+#define APP_LOG_RING_WORDS              (256u)
+#endif
+
+/* Frame sent on the UART for each record: APP_LOG_FRAME_SYNC, the number of
+ * words that follow, then the record words in little endian */
+#define APP_LOG_FRAME_SYNC              (0xA5u)
+
+/* Device addresses are logged as two words */
+#define APP_LOG_BDA_LO(bda)             ((uint32_t)(bda)[0] | ((uint32_t)(bda)[1] << 8) | ((uint32_t)(bda)[2] << 16) | ((uint32_t)(bda)[3] << 24))
+#define APP_LOG_BDA_HI(bda)             ((uint32_t)(bda)[4] | ((uint32_t)(bda)[5] << 8))
+
+#define APP_LOG_WRITE(id, ...) \
+    do { const uint32_t app_log_args[] = { 0, ##__VA_ARGS__ }; \
+         app_log_write((id), (uint8_t)(sizeof(app_log_args) / sizeof(uint32_t) - 1u), &app_log_args[1]); } while (0)
+
+#define APP_LOG0(id)                    APP_LOG_WRITE(id)
+#define APP_LOG1(id, a)                 APP_LOG_WRITE(id, (uint32_t)(a))
+#define APP_LOG2(id, a, b)              APP_LOG_WRITE(id, (uint32_t)(a), (uint32_t)(b))
+#define APP_LOG3(id, a, b, c)           APP_LOG_WRITE(id, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c))
+#define APP_LOG4(id, a, b, c, d)        APP_LOG_WRITE(id, (uint32_t)(a), (uint32_t)(b), (uint32_t)(c), (uint32_t)(d))
+#define APP_LOG_BDA1(id, bda, a)        APP_LOG_WRITE(id, APP_LOG_BDA_LO(bda), APP_LOG_BDA_HI(bda), (uint32_t)(a))
+#define APP_LOG_BDA2(id, bda, a, b)     APP_LOG_WRITE(id, APP_LOG_BDA_LO(bda), APP_LOG_BDA_HI(bda), (uint32_t)(a), (uint32_t)(b))
+
+#else
+
+extern const char * const app_log_fmt[APP_LOG_ID_COUNT];
+
+#define APP_LOG0(id)                    WICED_BT_TRACE(app_log_fmt[id])
+#define APP_LOG1(id, a)                 WICED_BT_TRACE(app_log_fmt[id], (a))
+#define APP_LOG2(id, a, b)              WICED_BT_TRACE(app_log_fmt[id], (a), (b))
+#define APP_LOG3(id, a, b, c)           WICED_BT_TRACE(app_log_fmt[id], (a), (b), (c))
+#define APP_LOG4(id, a, b, c, d)        WICED_BT_TRACE(app_log_fmt[id], (a), (b), (c), (d))
+#define APP_LOG_BDA1(id, bda, a)        WICED_BT_TRACE(app_log_fmt[id], (bda), (a))
+#define APP_LOG_BDA2(id, bda, a, b)     WICED_BT_TRACE(app_log_fmt[id], (bda), (a), (b))
+
+#define app_log_drain()
+
+/* Trace output is written straight into the debug UART; sleeping before the
+ * transmit FIFO has emptied would cut it off */
+#define app_log_idle()                  (wiced_hal_puart_is_tx_fifo_empty())
+
+#endif /* APP_BINARY_LOG */
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#ifdef APP_BINARY_LOG
+
+/**************************************************************************************************
+* Function Name: app_log_write()
+***************************************************************************************************
+* Summary:
+*   This function copies a record into the RAM ring and requests a background flush. Use the
+*   APP_LOG macros rather than calling it directly
+*
+* Parameters:
+*   app_log_id_t id                     : Message ID
+*   uint8_t nargs                       : Number of argument words
+*   const uint32_t *p_args              : Argument words
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_log_write(app_log_id_t id, uint8_t nargs, const uint32_t *p_args);
+
+/**************************************************************************************************
+* Function Name: app_log_drain()
+***************************************************************************************************
+* Summary:
+*   This function writes the queued records to the debug UART. It runs from the application
+*   event queue, outside the Bluetooth stack callbacks
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_log_drain(void);
+
+/**************************************************************************************************
+* Function Name: app_log_idle()
+***************************************************************************************************
+* Summary:
+*   This function reports whether every record has been sent on the UART
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if the ring is empty, no loss is left to report and the UART transmit FIFO
+*   has emptied
+*
+**************************************************************************************************/
+wiced_bool_t app_log_idle(void);
+
+#endif /* APP_BINARY_LOG */
+
+#endif /* APP_LOG_H_ */
@@ -0,0 +1,72 @@
+/*******************************************************************************
+* File Name: app_log_ids.h
+*
+* Description: Log message table shared by the firmware and scripts/decode_binary_log.py.
+*              Each entry is X(ID, format); the ID is the entry's position, so only append
+*              new entries and never reorder them
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_LOG_IDS_H_
+#define APP_LOG_IDS_H_
+
+/* Formats use the WICED_BT_TRACE conversions %d, %u, %x and %B (a device address) */
+#define APP_LOG_IDS(X) \
+    X(APP_LOG_ID_DROPPED,           "Log ring full, %d records lost\n\r") \
+    X(APP_LOG_ID_ADV_STATE,         "Advertisement State Change: %d\n\r") \
+    X(APP_LOG_ID_ADV_STOPPED,       "Advertisement stopped\n\r") \
+    X(APP_LOG_ID_ADV_STARTED,       "Advertisement started\n\r") \
+    X(APP_LOG_ID_ADV_POLICY,        "Advertising policy %d, reason 0x%x: mode %d\n\r") \
+    X(APP_LOG_ID_ADV_DIRECTED,      "Directed advertising to %B, %d bursts\n\r") \
+    X(APP_LOG_ID_RECONNECTED,       "Reconnected after %d ms\n\r") \
+    X(APP_LOG_ID_MGMT_UNHANDLED,    "Unhandled Bluetooth Management Event: 0x%x (%d)\n\r") \
+    X(APP_LOG_ID_ENCRYPTION,        "Encryption Status: %B, result %d\n\r") \
+    X(APP_LOG_ID_CONNECTED,         "Connected : BDA '%B', Connection ID '%d'\n\r") \
+    X(APP_LOG_ID_NO_CONN_ENTRY,     "No free connection entry, disconnecting\n\r") \
+    X(APP_LOG_ID_DISCONNECTED,      "Disconnected : BDA '%B', Connection ID '%d', Reason '%d'\n\r") \
+    X(APP_LOG_ID_ALERT_LEVEL,       "Alert Level = %d\n\r") \
+    X(APP_LOG_ID_MTU,               "MTU exchange, conn_id:%d MTU:%d\n\r") \
+    X(APP_LOG_ID_READ_INVALID,      "Read Request to Invalid Handle: 0x%x\n\r") \
+    X(APP_LOG_ID_PREP_INVALID,      "Prepare Write to Invalid Handle: 0x%x\n\r") \
+    X(APP_LOG_ID_PREP_FULL,         "Prepare Write queue full, conn_id:%d\n\r") \
+    X(APP_LOG_ID_LOCATOR,           "Locator alert level %d\n\r") \
+    X(APP_LOG_ID_LOCATOR_ALERTED,   "Locator alerted %B in %d ms, cache hit %d\n\r") \
+    X(APP_LOG_ID_LOCATOR_UNREACHABLE, "Locator could not reach %B in %d ms\n\r") \
+    X(APP_LOG_ID_LOCATOR_NO_IAS,    "Locator found no Immediate Alert service, conn_id:%d\n\r") \
+    X(APP_LOG_ID_LINK_SETTINGS,     "Link %d: PHY %d/%d, %d tx octets\n\r") \
+    X(APP_LOG_ID_LINK_TRAFFIC,      "Link %d: tx %d rx %d bytes, goodput %d bps\n\r")
+
+#endif /* APP_LOG_IDS_H_ */
@@ -0,0 +1,229 @@
+/*******************************************************************************
+* File Name: app_power.c
+*
+* Description: Source file for power management: registers the sleep permission handler
+*              that lets the device sleep while the application is idle, and accounts the
+*              time spent in each power state
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifdef APP_SLEEP
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced_bt_trace.h"
+#include "wiced_sleep.h"
+#include "wiced_platform.h"
+#include "app_power.h"
+#include "app_event_queue.h"
+#include "app_log.h"
+#include "app_user_interface.h"
+#include "app_time.h"
+
+/*******************************************************************************
+*        Macro Definitions
+*******************************************************************************/
+/* The LED timer wakes the device for each blink tick by itself, so blinking
+ * does not need to keep the device awake. Set to 1 for boards whose LED
+ * output is not held during sleep */
+#ifndef APP_POWER_BLINK_BLOCKS_SLEEP
+#define APP_POWER_BLINK_BLOCKS_SLEEP    (0)
+#endif
+
+/*******************************************************************************
+*        Variable Definitions
+*******************************************************************************/
+static wiced_sleep_config_t app_power_sleep_config;
+static app_power_state_t    app_power_state = APP_POWER_STATE_ACTIVE;
+static uint32_t             app_power_state_start_ms = 0;
+static app_power_stats_t    app_power_stats;
+
+/*******************************************************************************
+*        Function Definitions
+*******************************************************************************/
+
+/**************************************************************************************************
+* Function Name: app_power_set_state()
+***************************************************************************************************
+* Summary:
+*   This function accounts the time since the last poll answer to the current power state and
+*   moves to a new one
+*
+* Parameters:
+*   app_power_state_t state             : New power state
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+static void app_power_set_state(app_power_state_t state)
+{
+    uint32_t now_ms = app_time_ms();
+
+    app_power_stats.poll_state_ms[app_power_state] += now_ms - app_power_state_start_ms;
+    app_power_state_start_ms = now_ms;
+    app_power_state = state;
+}
+
+/**************************************************************************************************
+* Function Name: app_power_idle()
+***************************************************************************************************
+* Summary:
+*   This function checks whether the application has work outstanding that sleep would delay
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if the application is idle
+*
+**************************************************************************************************/
+static wiced_bool_t app_power_idle(void)
+{
+    if (!app_event_queue_idle())
+    {
+        app_power_stats.denied_queue++;
+        return WICED_FALSE;
+    }
+    if (!app_log_idle())
+    {
+        app_power_stats.denied_log++;
+        return WICED_FALSE;
+    }
+    if (APP_POWER_BLINK_BLOCKS_SLEEP && led_blinking())
+    {
+        app_power_stats.denied_blink++;
+        return WICED_FALSE;
+    }
+    return WICED_TRUE;
+}
+
+/**************************************************************************************************
+* Function Name: app_power_sleep_permit_handler()
+***************************************************************************************************
+* Summary:
+*   This function is polled by the stack before it sleeps
+*
+* Parameters:
+*   wiced_sleep_poll_type_t type        : WICED_SLEEP_POLL_TIME_TO_SLEEP or
+*                                         WICED_SLEEP_POLL_SLEEP_PERMISSION
+*
+* Return:
+*   For WICED_SLEEP_POLL_TIME_TO_SLEEP, how long the application can sleep; for
+*   WICED_SLEEP_POLL_SLEEP_PERMISSION, whether it may sleep
+*
+**************************************************************************************************/
+static uint32_t app_power_sleep_permit_handler(wiced_sleep_poll_type_t type)
+{
+    uint32_t ret = 0;
+    wiced_bool_t idle = WICED_FALSE;
+
+    switch (type)
+    {
+        case WICED_SLEEP_POLL_TIME_TO_SLEEP:
+            /* Timers bound the sleep time themselves; only pending work keeps us up */
+            app_power_stats.polls++;
+            idle = app_power_idle();
+            app_power_set_state(idle ? APP_POWER_STATE_SLEEP : APP_POWER_STATE_ACTIVE);
+            ret = idle ? WICED_SLEEP_MAX_TIME_TO_SLEEP : 0;
+            break;
+
+        case WICED_SLEEP_POLL_SLEEP_PERMISSION:
+            /* Sleep keeps RAM and the LED outputs; shutdown sleep would lose both */
+            ret = (app_power_state == APP_POWER_STATE_SLEEP) ? WICED_SLEEP_ALLOWED_WITHOUT_SHUTDOWN : WICED_SLEEP_NOT_ALLOWED;
+            break;
+
+        default:
+            break;
+    }
+    return ret;
+}
+
+/**************************************************************************************************
+* Function Name: app_power_init()
+***************************************************************************************************
+* Summary:
+*   This function configures the low power sleep mode and registers the sleep permission handler
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_power_init(void)
+{
+    app_power_state_start_ms = app_time_ms();
+
+    /* No HCI transport is used, so the device wakes only on its own timers,
+     * the radio and the button */
+    app_power_sleep_config.sleep_mode = WICED_SLEEP_MODE_NO_TRANSPORT;
+    app_power_sleep_config.host_wake_mode = WICED_SLEEP_WAKE_ACTIVE_HIGH;
+    app_power_sleep_config.device_wake_mode = WICED_SLEEP_WAKE_ACTIVE_LOW;
+    app_power_sleep_config.device_wake_source = WICED_SLEEP_WAKE_SOURCE_GPIO;
+    app_power_sleep_config.device_wake_gpio_num = WICED_GET_PIN_FOR_BUTTON(WICED_PLATFORM_BUTTON_1);
+    app_power_sleep_config.sleep_permit_handler = app_power_sleep_permit_handler;
+
+    if (wiced_sleep_configure(&app_power_sleep_config) != WICED_SUCCESS)
+    {
+        WICED_BT_TRACE("Sleep configuration failed\n\r");
+    }
+}
+
+/**************************************************************************************************
+* Function Name: app_power_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the power statistics, with the current state accounted up to now
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_power_stats_t *app_power_get_stats(void)
+{
+    app_power_set_state(app_power_state);
+    return &app_power_stats;
+}
+
+#endif /* APP_SLEEP */
+
+/* [] END OF FILE */
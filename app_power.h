@@ -0,0 +1,115 @@
+/*******************************************************************************
+* File Name: app_power.h
+*
+* Description: Header file for power management: registers the sleep permission handler
+*              that lets the device sleep while the application is idle, and accounts the
+*              time spent in each power state
+*
+* Related Document: See Readme.md
+*
+*******************************************************************************
+* Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#ifndef APP_POWER_H_
+#define APP_POWER_H_
+
+/*******************************************************************************
+*        Header Files
+*******************************************************************************/
+#include "wiced.h"
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* Power states, as last answered to the stack's sleep permission poll */
+typedef enum
+{
+    APP_POWER_STATE_ACTIVE,         /* Application work pending, sleep refused */
+    APP_POWER_STATE_SLEEP,          /* Application idle, sleep permitted */
+    APP_POWER_STATE_COUNT
+} app_power_state_t;
+
+/* Power statistics */
+typedef struct
+{
+    uint32_t poll_state_ms[APP_POWER_STATE_COUNT];  /* Time from each poll answer to the next one. The
+                                                     * SLEEP entry bounds the time asleep from above;
+                                                     * the stack may still stay awake for radio work */
+    uint32_t polls;                             /* Sleep permission polls from the stack */
+    uint32_t denied_queue;                      /* Refusals: application events pending */
+    uint32_t denied_log;                        /* Refusals: log output not yet sent on the UART */
+    uint32_t denied_blink;                      /* Refusals: LED pattern blinking */
+} app_power_stats_t;
+
+/*******************************************************************************
+*        Function Prototypes
+*******************************************************************************/
+#ifdef APP_SLEEP
+
+/**************************************************************************************************
+* Function Name: app_power_init()
+***************************************************************************************************
+* Summary:
+*   This function configures the low power sleep mode and registers the sleep permission handler
+*
+* Parameters:
+*   None
+*
+* Return:
+*   None
+*
+**************************************************************************************************/
+void app_power_init(void);
+
+/**************************************************************************************************
+* Function Name: app_power_get_stats()
+***************************************************************************************************
+* Summary:
+*   This function returns the power statistics, with the current state accounted up to now
+*
+* Parameters:
+*   None
+*
+* Return:
+*   Pointer to the statistics
+*
+**************************************************************************************************/
+const app_power_stats_t *app_power_get_stats(void);
+
+#else
+
+#define app_power_init()
+
+#endif /* APP_SLEEP */
+
+#endif /* APP_POWER_H_ */
@@ -47,19 +47,69 @@
 #include "wiced_platform.h"
 #include "wiced_hal_gpio.h"
 #include "GeneratedSource/cycfg_gatt_db.h"
+#include "app_latency.h"
+#include "app_ias.h"
+#include "app_event_queue.h"
+
+/*******************************************************************************
+*        Structures and Enumerations
+*******************************************************************************/
+/* LEDs driven by the blink patterns */
+typedef enum
+{
+    LED_ADV,
+    LED_IAS,
+    LED_COUNT
+} led_t;
+
+/* Blink patterns. A pattern lasts 'period' ticks of LED_TICK_MS and the LED
+ * is on during tick i if bit i of 'on_mask' is set. Patterns with a period of
+ * one tick are steady and need no timer */
+typedef enum
+{
+    LED_PATTERN_OFF,
+    LED_PATTERN_ON,
+    LED_PATTERN_ADV_BLINK,
+    LED_PATTERN_CONN_ADV,
+    LED_PATTERN_ALERT_MID,
+    LED_PATTERN_ALERT_HIGH,
+} led_pattern_t;
+
+typedef struct
+{
+    uint8_t period;
+    uint8_t on_mask;
+} led_pattern_def_t;
 
 /*******************************************************************************
 *        Variable Definitions
 *******************************************************************************/
-static wiced_timer_t adv_led_timer, ias_led_timer;
-static wiced_bool_t adv_timer_stopped_flag = WICED_TRUE;
-static wiced_bool_t ias_timer_stopped_flag = WICED_TRUE;
+static const led_pattern_def_t led_patterns[] =
+{
+    [LED_PATTERN_OFF]        = { 1, 0x00 },
+    [LED_PATTERN_ON]         = { 1, 0x01 },
+    [LED_PATTERN_ADV_BLINK]  = { 2, 0x01 },     /* 250 ms on, 250 ms off */
+    [LED_PATTERN_CONN_ADV]   = { 8, 0x7F },     /* On, with a 250 ms off blip every 2 s */
+    [LED_PATTERN_ALERT_MID]  = { 2, 0x01 },     /* 250 ms on, 250 ms off */
+    [LED_PATTERN_ALERT_HIGH] = { 1, 0x01 },     /* Steady on */
+};
+
+/* One timer serves every LED. All patterns run off the same tick count, so
+ * they stay in phase and share each wakeup */
+static wiced_timer_t led_timer;
+static wiced_bool_t  led_timer_running = WICED_FALSE;
+static uint32_t      led_tick = 0;
+static uint8_t       led_pattern[LED_COUNT];
+static uint32_t      led_gpio[LED_COUNT];
 
 /*******************************************************************************
 *        Function Prototypes
 *******************************************************************************/
-static void ias_led_timer_cb(uint32_t arg);
-static void adv_led_timer_cb(uint32_t arg);
+static void led_set_pattern(led_t led, led_pattern_t pattern);
+static void led_timer_cb(uint32_t arg);
+#ifdef APP_LOCATOR
+static void button_cb(void *data, uint8_t port_pin);
+#endif
 
 /*******************************************************************************
 *        Function Definitions
@@ -82,12 +132,17 @@ static void adv_led_timer_cb(uint32_t arg);
 *******************************************************************************/
 void app_user_interface_init(void)
 {
-    /* Initialize the timers used for advertising state LED, and IAS alert
-     * level LED */
-#ifndef SINGLE_LED
-    wiced_init_timer(&adv_led_timer, adv_led_timer_cb, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+    led_gpio[LED_ADV] = ADV_LED_GPIO;
+    led_gpio[LED_IAS] = IAS_LED_GPIO;
+
+    /* Initialize the timer shared by the advertising state LED and the IAS
+     * alert level LED. It only runs while a pattern blinks */
+    wiced_init_timer(&led_timer, led_timer_cb, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
+
+#ifdef APP_LOCATOR
+    /* The user button starts and stops the locator alert on bonded peers */
+    wiced_platform_register_button_callback(WICED_PLATFORM_BUTTON_1, button_cb, NULL, WICED_PLATFORM_BUTTON_RISING_EDGE);
 #endif
-    wiced_init_timer(&ias_led_timer, ias_led_timer_cb, 0, WICED_MILLI_SECONDS_PERIODIC_TIMER);
 }
 
 /*******************************************************************************
@@ -110,34 +165,31 @@ void app_user_interface_init(void)
 void adv_led_update(void)
 {
 #ifndef SINGLE_LED
-    /* Stop the advertising led timer */
-    wiced_stop_timer(&adv_led_timer);
-
-    /* Set the stop flag to prevent any pending timer callback to change LED
-     * state */
-    adv_timer_stopped_flag = WICED_TRUE;
-
     /* Set LED state based on BLE advertising/connection state.
      * LED OFF for no advertisement/connection, LED blinking for advertisement
-     * state, and LED ON for connected state  */
+     * state, LED ON for connected state, and LED ON with a short off blip
+     * when connected and still advertising for more clients  */
     switch(app_bt_adv_conn_state)
     {
         case APP_BT_ADV_OFF_CONN_OFF:
-            wiced_hal_gpio_set_pin_output(ADV_LED_GPIO, LED_OFF);
+            led_set_pattern(LED_ADV, LED_PATTERN_OFF);
             break;
 
         case APP_BT_ADV_ON_CONN_OFF:
-            wiced_start_timer(&adv_led_timer, ADV_LED_UPDATE_RATE_MS);
-            adv_timer_stopped_flag = WICED_FALSE;
+            led_set_pattern(LED_ADV, LED_PATTERN_ADV_BLINK);
             break;
 
         case APP_BT_ADV_OFF_CONN_ON:
-            wiced_hal_gpio_set_pin_output(ADV_LED_GPIO, LED_ON);
+            led_set_pattern(LED_ADV, LED_PATTERN_ON);
+            break;
+
+        case APP_BT_ADV_ON_CONN_ON:
+            led_set_pattern(LED_ADV, LED_PATTERN_CONN_ADV);
             break;
 
         default:
             /* LED OFF for unexpected states */
-            wiced_hal_gpio_set_pin_output(ADV_LED_GPIO, LED_OFF);
+            led_set_pattern(LED_ADV, LED_PATTERN_OFF);
             break;
     }
 #endif
@@ -160,53 +212,125 @@ void adv_led_update(void)
 *******************************************************************************/
 void ias_led_update(void)
 {
-    /* Stop the IAS led timer */
-    wiced_stop_timer(&ias_led_timer);
+    /* Set LED state based on the highest IAS alert level of the connected
+     * clients. LED OFF for low level, LED blinking for mid level, and LED ON
+     * for high level. Disconnected clients no longer count, so the LED turns
+     * off once the last alerting client has gone */
+    switch(app_ias_get_alert_level())
+    {
+        case IAS_ALERT_LEVEL_LOW:
+            led_set_pattern(LED_IAS, LED_PATTERN_OFF);
+            break;
+
+        case IAS_ALERT_LEVEL_MID:
+            led_set_pattern(LED_IAS, LED_PATTERN_ALERT_MID);
+            break;
 
-    /* Set the stop flag to prevent any pending timer callback to change LED
-     * state */
-    ias_timer_stopped_flag = WICED_TRUE;
+        case IAS_ALERT_LEVEL_HIGH:
+            led_set_pattern(LED_IAS, LED_PATTERN_ALERT_HIGH);
+            break;
+
+        default:
+            /* Consider any other level as High alert level */
+            led_set_pattern(LED_IAS, LED_PATTERN_ALERT_HIGH);
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: led_blinking()
+********************************************************************************
+*
+* Summary:
+*   This function reports whether any LED pattern is blinking, i.e. whether
+*   the shared LED timer is running
+*
+* Parameters:
+*   None
+*
+* Return:
+*   WICED_TRUE if the LED timer is running
+*
+*******************************************************************************/
+wiced_bool_t led_blinking(void)
+{
+    return led_timer_running;
+}
 
-    /* Update LED based on IAS alert level only when the device is connected */
-    if(app_bt_adv_conn_state == APP_BT_ADV_OFF_CONN_ON)
+/*******************************************************************************
+* Function Name: led_apply()
+********************************************************************************
+*
+* Summary:
+*   This function drives an LED to the state its pattern has for the current
+*   tick
+*
+* Parameters:
+*   led_t led - LED to drive
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void led_apply(led_t led)
+{
+    const led_pattern_def_t *p_def = &led_patterns[led_pattern[led]];
+    wiced_bool_t on = (p_def->on_mask >> (led_tick % p_def->period)) & 1u;
+
+    wiced_hal_gpio_set_pin_output(led_gpio[led], on ? LED_ON : LED_OFF);
+}
+
+/*******************************************************************************
+* Function Name: led_set_pattern()
+********************************************************************************
+*
+* Summary:
+*   This function selects the pattern of an LED, and starts or stops the
+*   shared timer depending on whether any pattern still blinks
+*
+* Parameters:
+*   led_t led               - LED to update
+*   led_pattern_t pattern   - Pattern to show
+*
+* Return:
+*   None
+*
+*******************************************************************************/
+static void led_set_pattern(led_t led, led_pattern_t pattern)
+{
+    wiced_bool_t blinking = WICED_FALSE;
+
+    led_pattern[led] = (uint8_t)pattern;
+    led_apply(led);
+
+    for (int i = 0; i < LED_COUNT; i++)
     {
-        /* Set LED state based on IAS alert level. LED OFF for low level,
-         * LED blinking for mid level, and LED ON for high level  */
-        switch(app_ias_alert_level[0])
+        if (led_patterns[led_pattern[i]].period > 1)
         {
-            case IAS_ALERT_LEVEL_LOW:
-                wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_OFF);
-                break;
-
-            case IAS_ALERT_LEVEL_MID:
-                ias_timer_stopped_flag = WICED_FALSE;
-                wiced_start_timer(&ias_led_timer, IAS_LED_UPDATE_RATE_MS);
-                break;
-
-            case IAS_ALERT_LEVEL_HIGH:
-                wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_ON);
-                break;
-
-            default:
-                /* Consider any other level as High alert level */
-                wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_ON);
-                break;
+            blinking = WICED_TRUE;
         }
     }
-    else
+
+    if (blinking && !led_timer_running)
     {
-        /* In case of disconnection, turn off the IAS LED */
-        wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_OFF);
+        wiced_start_timer(&led_timer, LED_TICK_MS);
+        led_timer_running = WICED_TRUE;
+    }
+    else if (!blinking && led_timer_running)
+    {
+        /* Nothing blinks: no wakeups until a pattern starts again */
+        wiced_stop_timer(&led_timer);
+        led_timer_running = WICED_FALSE;
     }
 }
 
 /*******************************************************************************
-* Function Name: adv_led_timer_cb()
+* Function Name: led_timer_cb()
 ********************************************************************************
 *
 * Summary:
-*   This timer callback function toggles the state of the advertising LED and is
-*   used to indicate the device is advertising
+*   This timer callback function advances the shared tick and drives every
+*   blinking LED to its state for the new tick
 *
 * Parameters:
 *   uint32_t arg - The argument parameter is not used in this callback
@@ -215,53 +339,46 @@ void ias_led_update(void)
 *   None
 *
 *******************************************************************************/
-static void adv_led_timer_cb(uint32_t arg)
+static void led_timer_cb(uint32_t arg)
 {
-    /* The timer stopped flag is checked to prevent any pending timer
-     * callback from changing LED state after the timer is stopped */
-    if(!adv_timer_stopped_flag)
+    APP_LATENCY_BEGIN();
+
+    led_tick++;
+
+    /* The output is recomputed from the pattern, so a callback that was
+     * already pending when the timer stopped leaves the LEDs unchanged */
+    for (int i = 0; i < LED_COUNT; i++)
     {
-        if(wiced_hal_gpio_get_pin_output(ADV_LED_GPIO) == LED_OFF)
+        if (led_patterns[led_pattern[i]].period > 1)
         {
-            wiced_hal_gpio_set_pin_output(ADV_LED_GPIO, LED_ON);
-        }
-        else
-        {
-            wiced_hal_gpio_set_pin_output(ADV_LED_GPIO, LED_OFF);
+            led_apply((led_t)i);
         }
     }
+
+    APP_LATENCY_END(APP_LATENCY_SITE_LED_TIMER, 0);
 }
 
+#ifdef APP_LOCATOR
 /*******************************************************************************
-* Function Name: ias_led_timer_cb()
+* Function Name: button_cb()
 ********************************************************************************
 *
 * Summary:
-*   This timer callback function toggles the state of the IAS LED and is
-*   used to indicate the alert level is mid level
+*   This function is called when the user button is released. The locator
+*   alert is toggled after the callback returns
 *
 * Parameters:
-*   uint32_t arg - The argument parameter is not used in this callback
+*   void *data          : Unused
+*   uint8_t port_pin    : Button pin
 *
 * Return:
 *   None
 *
 *******************************************************************************/
-static void ias_led_timer_cb(uint32_t arg)
+static void button_cb(void *data, uint8_t port_pin)
 {
-    /* The timer stopped flag is checked to prevent any pending timer
-     * callback from changing LED state after the timer is stopped */
-    if(!ias_timer_stopped_flag)
-    {
-        if(wiced_hal_gpio_get_pin_output(IAS_LED_GPIO) == LED_OFF)
-        {
-            wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_ON);
-        }
-        else
-        {
-            wiced_hal_gpio_set_pin_output(IAS_LED_GPIO, LED_OFF);
-        }
-    }
+    app_event_signal(APP_EVENT_BUTTON);
 }
+#endif
 
 /* [] END OF FILE */
@@ -65,9 +65,8 @@
  #endif
 #endif
 
-/* Update rate of LED's in milliseconds when blinking */
-#define ADV_LED_UPDATE_RATE_MS          250
-#define IAS_LED_UPDATE_RATE_MS          250
+/* Tick of the LED blink patterns in milliseconds */
+#define LED_TICK_MS                     250
 
 /* LED's on the kit are active low */
 #define LED_ON                          0
@@ -84,6 +83,7 @@
 void app_user_interface_init(void);
 void adv_led_update(void);
 void ias_led_update(void);
+wiced_bool_t led_blinking(void);
 
 #endif /* APP_USER_INTERFACE_H_ */
 
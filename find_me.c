@@ -46,6 +46,7 @@
 #include "wiced_bt_trace.h"
 #include "app_bt_event_handler.h"
 #include "wiced_bt_stack.h"
+#include "app_latency.h"
 /*******************************************************************************
 *        Macro Definitions
 *******************************************************************************/
@@ -56,8 +57,6 @@
 /*******************************************************************************
 *        Variable Definitions
 *******************************************************************************/
-extern const wiced_bt_cfg_buf_pool_t wiced_bt_cfg_buf_pools[WICED_BT_CFG_NUM_BUF_POOLS];
-
 /*******************************************************************************
 *        Function Prototypes
 *******************************************************************************/
@@ -87,6 +86,9 @@ void application_start(void)
 
     WICED_BT_TRACE("**** Find Me Profile Application Start ****\n\r");
 
+    /* Start the cycle counter before the first callback, if latency stats are enabled */
+    app_latency_init();
+
     /* Initialize Stack and Register Management Callback */
     wiced_bt_stack_init(app_bt_management_callback, &wiced_bt_cfg_settings, wiced_bt_cfg_buf_pools);;
 }
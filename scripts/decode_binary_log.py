@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+################################################################################
+# \file decode_binary_log.py
+# \version 1.0
+#
+# \brief
+# Decodes the binary log frames written by the application when it is built
+# with BINARY_LOG=1, using the message table in app_log_ids.h. Text printed
+# by WICED_BT_TRACE on the same UART is passed through unchanged.
+#
+# Frame: 0xA5, word count, then little endian 32-bit words: header (message
+# ID in bits 0-7, argument count in bits 8-15), timestamp in ms, arguments.
+#
+# Usage: decode_binary_log.py <app_log_ids.h> [capture file, default stdin]
+#
+################################################################################
+# \copyright
+# Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import re
+import struct
+import sys
+
+FRAME_SYNC = 0xA5
+
+# Matches app_log.c: two fixed words plus at most six arguments
+MAX_WORDS = 8
+
+ENTRY_RE = re.compile(r'X\(\s*(\w+)\s*,\s*"((?:[^"\\]|\\.)*)"\s*\)')
+CONVERSION_RE = re.compile(r'%(-?\d*)([dux%B])')
+
+
+def load_ids(header_path):
+    """Returns the format strings of app_log_ids.h, indexed by message ID."""
+    with open(header_path) as f:
+        text = f.read()
+    return [(name, fmt.encode().decode("unicode_escape"))
+            for name, fmt in ENTRY_RE.findall(text)]
+
+
+def format_message(fmt, args):
+    """Applies the WICED_BT_TRACE conversions of fmt to the argument words."""
+    args = list(args)
+
+    def convert(match):
+        width, conv = match.groups()
+        if conv == "%":
+            return "%"
+        if not args:
+            return "<missing>"
+        if conv == "B":
+            if len(args) < 2:
+                return "<missing>"
+            lo, hi = args.pop(0), args.pop(0)
+            addr = struct.pack("<IH", lo, hi & 0xFFFF)
+            return ":".join("%02x" % b for b in addr)
+        value = args.pop(0)
+        if conv == "d":
+            value = struct.unpack("<i", struct.pack("<I", value))[0]
+            return ("%" + width + "d") % value
+        if conv == "u":
+            return ("%" + width + "u") % value
+        return ("%" + width + "x") % value
+
+    return CONVERSION_RE.sub(convert, fmt)
+
+
+def decode(data, ids, out):
+    """Splits the capture into text and frames and writes the decoded log."""
+    i = 0
+    text = bytearray()
+    while i < len(data):
+        nwords = data[i + 1] if i + 1 < len(data) else 0
+        end = i + 2 + 4 * nwords
+        if data[i] == FRAME_SYNC and 2 <= nwords <= MAX_WORDS and end <= len(data):
+            words = struct.unpack("<%dI" % nwords, data[i + 2:end])
+            msg_id, nargs = words[0] & 0xFF, (words[0] >> 8) & 0xFF
+            # Anything inconsistent is taken to be text that happened to contain 0xA5
+            if msg_id < len(ids) and nargs == nwords - 2:
+                out.write(text.decode(errors="replace"))
+                text.clear()
+                out.write("[%10u] %s" % (words[1], format_message(ids[msg_id][1], words[2:])))
+                i = end
+                continue
+        text.append(data[i])
+        i += 1
+    out.write(text.decode(errors="replace"))
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        sys.exit("Usage: %s <app_log_ids.h> [capture file]" % sys.argv[0])
+
+    ids = load_ids(sys.argv[1])
+    if len(sys.argv) == 3:
+        with open(sys.argv[2], "rb") as f:
+            data = f.read()
+    else:
+        data = sys.stdin.buffer.read()
+
+    decode(data, ids, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,202 @@
+#!/usr/bin/env python3
+################################################################################
+# \file estimate_energy.py
+# \version 1.0
+#
+# \brief
+# Estimates radio airtime, wakeups and average current of the tag from the
+# settings in app_bt_cfg.c and the connection parameter profiles in
+# app_bt_conn_param.c, for each operating phase (high duty advertising, low
+# duty advertising, connected idle with and without advertising for further
+# locators, alerting) and for a daily usage scenario.
+#
+# The settings are read from the C initializers, so the SDK is not needed.
+# The current model uses typical figures for the CYW208xx family; calibrate
+# it once against a bench measurement with the --tx-ma, --rx-ma, --sleep-ua
+# and --wake-uc options, then compare configurations with the tool alone.
+#
+# Usage: estimate_energy.py <app_bt_cfg.c> <app_bt_conn_param.c>
+#                           [--scenario phase=hours,...] [-D NAME=VALUE ...]
+#
+################################################################################
+# \copyright
+# Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import argparse
+import re
+import sys
+
+# SDK defaults referenced by app_bt_cfg.c (wiced_bt_cfg.h); override with -D
+# if the SDK in use differs
+SDK_DEFINES = {
+    "WICED_BT_CFG_DEFAULT_HIGH_DUTY_ADV_MIN_INTERVAL": 48,
+    "WICED_BT_CFG_DEFAULT_HIGH_DUTY_ADV_MAX_INTERVAL": 48,
+    "WICED_BT_CFG_DEFAULT_CONN_MIN_INTERVAL": 112,
+    "WICED_BT_CFG_DEFAULT_CONN_MAX_INTERVAL": 128,
+    "WICED_BT_CFG_DEFAULT_CONN_LATENCY": 0,
+}
+
+# Transmit current in mA by output power in dBm; interpolated in between
+TX_MA_BY_DBM = [(-8, 4.0), (-4, 4.6), (0, 5.9), (4, 8.0), (8, 11.0), (12, 15.0)]
+
+RX_MA = 5.9             # Receive current
+SLEEP_UA = 2.5          # Sleep current between events
+WAKE_UC = 4.0           # Charge per wakeup: clock start-up and event setup
+
+BYTE_US = 8             # Air time of one byte on the LE 1M PHY
+T_IFS_US = 150          # Inter frame space
+ADV_OVERHEAD_BYTES = 16 # Preamble, access address, header, AdvA and CRC
+ADV_LISTEN_US = 180     # Receive window after each connectable advertising PDU
+ADV_DELAY_MS = 5.0      # Mean of the 0-10 ms random advertising delay
+EMPTY_PDU_BYTES = 10    # Empty LL data PDU with preamble, access address and CRC
+SCA_PPM = 520           # Sleep clock accuracy of both sides, for window widening
+
+# Advertising payload of app_bt_adv.c: flags, IAS service UUID, appearance
+ADV_DATA_LEN = 11
+ADV_CHANNELS = 3
+
+# Connected time is spent in conn_adv during the low duty window app_bt_adv.c
+# opens after each connection or disconnection (APP_BT_ADV_WHILE_CONNECTED),
+# in conn_idle otherwise
+DEFAULT_SCENARIO = "high_adv=0.1,low_adv=2,conn_idle=21.7,conn_adv=0.1,alerting=0.1"
+
+PHASES = ("high_adv", "low_adv", "conn_idle", "conn_adv", "alerting")
+
+
+def read_settings(paths, defines):
+    """Returns the .field = value and #define values of the given C files"""
+    values = dict(SDK_DEFINES)
+    values.update(defines)
+    fields = {}
+    for path in paths:
+        with open(path) as f:
+            text = re.sub(r"/\*.*?\*/", "", f.read(), flags=re.S)
+        for name, value in re.findall(r"^\s*#define\s+(\w+)\s+\(?(-?\w+?)u?\)?\s*$", text, flags=re.M):
+            values.setdefault(name, value)
+        for name, value in re.findall(r"\.(\w+)\s*=\s*([-\w]+)", text):
+            fields.setdefault(name, value)
+
+    def resolve(token):
+        seen = set()
+        while not re.fullmatch(r"-?\d+", str(token)):
+            if token in seen or token not in values:
+                sys.exit("Cannot resolve %s; pass it with -D %s=<value>" % (token, token))
+            seen.add(token)
+            token = values[token]
+        return int(token)
+
+    return fields, values, resolve
+
+
+def tx_ma(dbm):
+    """Interpolates the transmit current for an output power"""
+    points = TX_MA_BY_DBM
+    if dbm <= points[0][0]:
+        return points[0][1]
+    for (d0, i0), (d1, i1) in zip(points, points[1:]):
+        if dbm <= d1:
+            return i0 + (i1 - i0) * (dbm - d0) / (d1 - d0)
+    return points[-1][1]
+
+
+def adv_phase(interval_units):
+    """Events per hour and transmit / receive us per event of advertising"""
+    interval_ms = interval_units * 0.625 + ADV_DELAY_MS
+    tx_us = ADV_CHANNELS * (ADV_OVERHEAD_BYTES + ADV_DATA_LEN) * BYTE_US
+    rx_us = ADV_CHANNELS * (T_IFS_US + ADV_LISTEN_US)
+    return 3600e3 / interval_ms, tx_us, rx_us
+
+
+def conn_phase(interval_units, latency):
+    """Events per hour and transmit / receive us per event of an idle link"""
+    interval_ms = interval_units * 1.25
+    event_ms = interval_ms * (1 + latency)
+    # The receive window widens with the time since the last anchor point
+    widening_us = 2 * SCA_PPM * event_ms / 1000.0 + 16
+    rx_us = EMPTY_PDU_BYTES * BYTE_US + widening_us
+    tx_us = EMPTY_PDU_BYTES * BYTE_US
+    return 3600e3 / event_ms, tx_us, rx_us + T_IFS_US
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Estimates airtime, wakeups and average current per phase")
+    parser.add_argument("cfg", help="app_bt_cfg.c")
+    parser.add_argument("conn_param", help="app_bt_conn_param.c")
+    parser.add_argument("--scenario", default=DEFAULT_SCENARIO,
+                        help="hours per day in each phase (default %s)" % DEFAULT_SCENARIO)
+    parser.add_argument("--battery-mah", type=float, default=220.0, help="battery capacity (default CR2032)")
+    parser.add_argument("--tx-ma", type=float, help="transmit current, overriding the power level table")
+    parser.add_argument("--rx-ma", type=float, default=RX_MA)
+    parser.add_argument("--sleep-ua", type=float, default=SLEEP_UA)
+    parser.add_argument("--wake-uc", type=float, default=WAKE_UC)
+    parser.add_argument("-D", dest="defines", action="append", default=[], metavar="NAME=VALUE",
+                        help="value of a macro the sources do not define")
+    args = parser.parse_args()
+
+    defines = dict(d.split("=", 1) for d in args.defines)
+    fields, values, resolve = read_settings([args.cfg, args.conn_param], defines)
+
+    power_dbm = resolve(fields.get("default_ble_power_level", "0"))
+    i_tx = args.tx_ma if args.tx_ma is not None else tx_ma(power_dbm)
+
+    phases = {
+        "high_adv": adv_phase((resolve(fields["high_duty_min_interval"]) +
+                               resolve(fields["high_duty_max_interval"])) / 2.0),
+        "low_adv": adv_phase((resolve(fields["low_duty_min_interval"]) +
+                              resolve(fields["low_duty_max_interval"])) / 2.0),
+        "conn_idle": conn_phase((resolve("APP_BT_CONN_PARAM_IDLE_MIN_INTERVAL") +
+                                 resolve("APP_BT_CONN_PARAM_IDLE_MAX_INTERVAL")) / 2.0,
+                                resolve("APP_BT_CONN_PARAM_IDLE_LATENCY")),
+        "alerting": conn_phase((resolve("APP_BT_CONN_PARAM_ALERT_MIN_INTERVAL") +
+                                resolve("APP_BT_CONN_PARAM_ALERT_MAX_INTERVAL")) / 2.0,
+                               resolve("APP_BT_CONN_PARAM_ALERT_LATENCY")),
+    }
+
+    # Both event streams run side by side; merge them into per-event averages
+    (conn_ev, conn_tx, conn_rx), (adv_ev, adv_tx, adv_rx) = phases["conn_idle"], phases["low_adv"]
+    events_h = conn_ev + adv_ev
+    phases["conn_adv"] = (events_h,
+                          (conn_ev * conn_tx + adv_ev * adv_tx) / events_h,
+                          (conn_ev * conn_rx + adv_ev * adv_rx) / events_h)
+
+    print("TX power %d dBm: TX %.1f mA, RX %.1f mA, sleep %.1f uA, wakeup %.1f uC"
+          % (power_dbm, i_tx, args.rx_ma, args.sleep_ua, args.wake_uc))
+    print("%-10s %14s %16s %14s" % ("phase", "wakeups/hour", "airtime ms/hour", "average uA"))
+
+    current_ua = {}
+    for name in PHASES:
+        events_h, tx_us, rx_us = phases[name]
+        charge_uc = args.wake_uc + (tx_us * i_tx + rx_us * args.rx_ma) / 1000.0
+        current_ua[name] = args.sleep_ua + events_h * charge_uc / 3600.0
+        print("%-10s %14.0f %16.1f %14.1f"
+              % (name, events_h, events_h * (tx_us + rx_us) / 1000.0, current_ua[name]))
+
+    scenario = {k: float(v) for k, v in (p.split("=", 1) for p in args.scenario.split(","))}
+    unknown = set(scenario) - set(PHASES)
+    if unknown:
+        sys.exit("Unknown phase(s) in scenario: %s" % ", ".join(sorted(unknown)))
+    hours = sum(scenario.values())
+    if hours <= 0:
+        sys.exit("Scenario covers no time")
+
+    average_ua = sum(current_ua[p] * h for p, h in scenario.items()) / hours
+    print("Scenario %s: %.1f uA average, %.0f days on %.0f mAh"
+          % (args.scenario, average_ua, args.battery_mah * 1000.0 / average_ua / 24.0, args.battery_mah))
+
+
+if __name__ == "__main__":
+    main()
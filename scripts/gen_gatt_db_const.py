@@ -0,0 +1,267 @@
+#!/usr/bin/env python3
+################################################################################
+# \file gen_gatt_db_const.py
+# \version 1.0
+#
+# \brief
+# Generates the flash-resident table of constant GATT attribute values from
+# the Bluetooth Configurator design file (cycfg_bt.cybt) and prints a
+# per-service RAM/flash size report. It runs on every build, so the table
+# cannot drift from the design.
+#
+# Characteristics that are readable but not writable never change at runtime,
+# so the application serves them from this table. The table neither packs nor
+# deduplicates the database: the RAM copies the configurator emits into
+# GeneratedSource are still linked, so it adds flash and does not save RAM.
+#
+# The attribute handles are numbered the way the Bluetooth Configurator does:
+# sequentially from 1, one for each service declaration, two for each
+# characteristic (declaration and value) and one for each descriptor. The
+# highest one sizes the handle-indexed lookup. The HDLS_/HDLC_ macro names are
+# looked up by handle in GeneratedSource/cycfg_gatt_db.h rather than derived
+# from the service and characteristic types, and the generated source checks
+# at compile time that the two still agree.
+#
+# The outputs are only rewritten when their content changes, so an unchanged
+# design does not trigger a rebuild of the files that include them.
+#
+# Usage: gen_gatt_db_const.py <design.cybt> <GeneratedSource dir> <output dir>
+#
+################################################################################
+# \copyright
+# Copyright 2021-2023, Cypress Semiconductor Corporation (an Infineon company)
+# SPDX-License-Identifier: Apache-2.0
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License.
+################################################################################
+
+import os
+import re
+import sys
+import xml.etree.ElementTree as ET
+
+# 16-bit UUIDs of the standard types, counted by the size report
+SERVICE_UUIDS = {
+    "org.bluetooth.service.generic_access":    0x1800,
+    "org.bluetooth.service.generic_attribute": 0x1801,
+    "org.bluetooth.service.immediate_alert":   0x1802,
+}
+
+CHARACTERISTIC_UUIDS = {
+    "org.bluetooth.characteristic.gap.device_name": 0x2A00,
+    "org.bluetooth.characteristic.gap.appearance":  0x2A01,
+    "org.bluetooth.characteristic.alert_level":     0x2A06,
+}
+
+# Bytes per entry in the stack GATT database: service declaration, and
+# characteristic declaration plus value attribute
+DB_SERVICE_BYTES = 8
+DB_CHARACTERISTIC_BYTES = 14
+LOOKUP_ENTRY_BYTES = 8
+
+WRITE_PERMISSIONS = ("Write", "WriteNoResponse", "WriteReliable", "WriteAuthenticated")
+
+OUTPUT_NAME = "app_gatt_db_const"
+HANDLE_HEADER = "cycfg_gatt_db.h"
+
+# "#define HDLS_GAP   0x0001" and "#define HDLC_GAP_DEVICE_NAME_VALUE   0x0003"
+HANDLE_MACRO = re.compile(r"^\s*#define\s+((HDLS)_(\w+)|(HDLC)_(\w+)_VALUE)\s+\(?\s*(0[xX][0-9a-fA-F]+|\d+)")
+
+
+def properties(node):
+    """Returns the <Property id= value=> children of node as a dict"""
+    return {p.get("id"): p.get("value") for p in node.findall("Property")}
+
+
+def handle_names(path):
+    """Returns {handle: name} for the HDLS_<name> service and HDLC_<name>_VALUE
+    characteristic value macros of the configurator's cycfg_gatt_db.h"""
+    services = {}
+    values = {}
+    with open(path) as f:
+        for line in f:
+            m = HANDLE_MACRO.match(line)
+            if not m:
+                continue
+            handle = int(m.group(6), 0)
+            if m.group(2):
+                services[handle] = m.group(3)
+            else:
+                values[handle] = m.group(5)
+    return services, values
+
+
+def lookup(names, handle, what, path):
+    if handle not in names:
+        sys.exit("%s: no %s macro for handle %d; regenerate GeneratedSource with the "
+                 "Bluetooth Configurator or build with GATT_DB_GEN=0" % (path, what, handle))
+    return names[handle]
+
+
+def field_bytes(field):
+    """Encodes the initial value of a characteristic field"""
+    props = properties(field.find("FieldProperties"))
+    fmt = props.get("Format", "")
+    length = int(props.get("ByteLength", "0") or 0)
+
+    if fmt in ("f_utf8s", "f_utf16s"):
+        data = props.get("Value", "").encode("utf-8")
+    else:
+        value = int(props.get("Value", props.get("EnumValue", "0")) or 0, 0)
+        width = {"f_uint8": 1, "f_sint8": 1, "f_8bit": 1,
+                 "f_uint16": 2, "f_sint16": 2, "f_16bit": 2,
+                 "f_uint32": 4, "f_sint32": 4, "f_32bit": 4}.get(fmt, 1)
+        data = value.to_bytes(width, "little")
+
+    if length > len(data):
+        data += bytes(length - len(data))
+    return data
+
+
+def parse(path, handle_header):
+    """Returns a list of (service name, uuid, handle, [characteristics]) from a .cybt file,
+    and the highest attribute handle"""
+    services = []
+    handle = 0
+    root = ET.parse(path).getroot()
+    service_names, value_names = handle_names(handle_header)
+
+    for service in root.iter("Service"):
+        service_type = service.get("type")
+        characteristics = []
+        handle += 1
+        service_handle = handle
+
+        for characteristic in service.iter("Characteristic"):
+            permission = properties(characteristic.find("Permission"))
+            value = b"".join(field_bytes(f) for f in characteristic.iter("Field"))
+            writable = any(permission.get(p) == "true" for p in WRITE_PERMISSIONS)
+            handle += 2
+            characteristics.append({
+                "name":     lookup(value_names, handle, "HDLC_<name>_VALUE", handle_header),
+                "uuid":     CHARACTERISTIC_UUIDS.get(characteristic.get("type")),
+                "value":    value,
+                "const":    (permission.get("Read") == "true") and not writable,
+                "handle":   handle,
+            })
+            handle += len(characteristic.findall("Descriptors/Descriptor"))
+
+        services.append((lookup(service_names, service_handle, "HDLS_<name>", handle_header),
+                         SERVICE_UUIDS.get(service_type), service_handle, characteristics))
+    return services, handle
+
+
+def c_bytes(data):
+    return ", ".join("0x%02X" % b for b in data)
+
+
+def write_if_changed(path, text):
+    """Writes text to path unless the file already holds it, leaving its timestamp alone"""
+    try:
+        with open(path, newline="\n") as f:
+            if f.read() == text:
+                return
+    except OSError:
+        pass
+    with open(path, "w", newline="\n") as f:
+        f.write(text)
+
+
+def write_sources(services, max_handle, out_dir, design):
+    banner = ("/* This file was generated by scripts/gen_gatt_db_const.py from %s.\n"
+              " * Do not edit; it is regenerated on every build (GATT_DB_GEN=1, the default). */\n" % os.path.basename(design))
+    constants = [ch for _, _, _, characteristics in services for ch in characteristics if ch["const"]]
+
+    h = [banner]
+    h.append("\n#ifndef APP_GATT_DB_CONST_H_\n#define APP_GATT_DB_CONST_H_\n\n")
+    h.append("#include <stdint.h>\n\n")
+    h.append("/* Highest attribute handle in the GATT database */\n")
+    h.append("#define APP_GATT_DB_CONST_MAX_HANDLE (%du)\n\n" % max_handle)
+    h.append("/* Length of each constant value, usable in compile-time checks */\n")
+    for ch in constants:
+        h.append("#define APP_GATT_DB_CONST_%s_LEN (%du)\n" % (ch["name"], len(ch["value"])))
+    h.append("\n")
+    h.append("/* Attribute value that never changes at runtime and is kept in flash */\n")
+    h.append("typedef struct\n{\n")
+    h.append("    uint16_t       handle;\n")
+    h.append("    uint16_t       len;\n")
+    h.append("    const uint8_t *p_data;\n")
+    h.append("} app_gatt_db_const_t;\n\n")
+    h.append("extern const app_gatt_db_const_t app_gatt_db_const_tbl[];\n")
+    h.append("extern const uint16_t app_gatt_db_const_tbl_size;\n\n")
+    h.append("#endif /* APP_GATT_DB_CONST_H_ */\n")
+
+    c = [banner]
+    c.append('\n#include "cycfg_gatt_db.h"\n#include "%s.h"\n\n' % OUTPUT_NAME)
+    c.append("/* Fail the build when GeneratedSource numbers the database differently */\n")
+    for service, _, service_handle, characteristics in services:
+        c.append('_Static_assert(HDLS_%s == %d, "Regenerate with GATT_DB_GEN=1");\n' % (service, service_handle))
+        for ch in characteristics:
+            c.append('_Static_assert(HDLC_%s_VALUE == %d, "Regenerate with GATT_DB_GEN=1");\n'
+                     % (ch["name"], ch["handle"]))
+    c.append("\n")
+    for ch in constants:
+        c.append("static const uint8_t app_%s_const[] = { %s };\n" % (ch["name"].lower(), c_bytes(ch["value"])))
+    c.append("\nconst app_gatt_db_const_t app_gatt_db_const_tbl[] =\n{\n")
+    for ch in constants:
+        var = "app_%s_const" % ch["name"].lower()
+        c.append("    { HDLC_%s_VALUE, sizeof(%s), %s },\n" % (ch["name"], var, var))
+    if not constants:
+        c.append("    { 0, 0, 0 },\n")
+    c.append("};\n\n")
+    c.append("const uint16_t app_gatt_db_const_tbl_size = %d;\n" % len(constants))
+
+    write_if_changed(os.path.join(out_dir, OUTPUT_NAME + ".h"), "".join(h))
+    write_if_changed(os.path.join(out_dir, OUTPUT_NAME + ".c"), "".join(c))
+
+
+def report(services):
+    uuids = set()
+    total_flash = total_ram = 0
+
+    # Every value keeps its RAM copy and lookup entry in GeneratedSource;
+    # constant ones are also copied into the flash table
+    print("GATT database size report")
+    print("  %-8s %6s %10s %10s" % ("Service", "Chars", "Flash (B)", "RAM (B)"))
+    for service, uuid, _, characteristics in services:
+        flash = DB_SERVICE_BYTES + DB_CHARACTERISTIC_BYTES * len(characteristics)
+        ram = 0
+        uuids.add(uuid)
+        for ch in characteristics:
+            uuids.add(ch["uuid"])
+            ram += len(ch["value"]) + LOOKUP_ENTRY_BYTES
+            if ch["const"]:
+                flash += len(ch["value"])
+        print("  %-8s %6d %10d %10d" % (service, len(characteristics), flash, ram))
+        total_flash += flash
+        total_ram += ram
+    print("  %-8s %6s %10d %10d" % ("Total", "", total_flash, total_ram))
+    print("  %d unique 16-bit UUIDs" % len(uuids - {None}))
+
+
+def main():
+    if len(sys.argv) != 4:
+        sys.exit("usage: %s <design.cybt> <GeneratedSource dir> <output dir>" % sys.argv[0])
+
+    handle_header = os.path.join(sys.argv[2], HANDLE_HEADER)
+    if not os.path.isfile(handle_header):
+        sys.exit("%s not found; generate it with the Bluetooth Configurator "
+                 "or build with GATT_DB_GEN=0" % handle_header)
+
+    services, max_handle = parse(sys.argv[1], handle_header)
+    write_sources(services, max_handle, sys.argv[3], sys.argv[1])
+    report(services)
+
+
+if __name__ == "__main__":
+    main()